@@ -4,27 +4,74 @@
   siggi@mit.edu
  */
  
-#include <util/atomic.h>
-#if defined(ARDUINO) && ARDUINO >= 100
-#include "Arduino.h"
+#include "ByteBuffer.h"
+
+#ifdef BYTEBUFFER_STATS
+#define BB_STAT_IN(n) do { stats.bytesIn += (n); if(length > stats.peakSize) stats.peakSize = length; } while(0)
+#define BB_STAT_OUT(n) (stats.bytesOut += (n))
+#define BB_STAT_OVERFLOW() (stats.overflows++)
+#define BB_STAT_UNDERFLOW() (stats.underflows++)
 #else
-#include "WProgram.h"
+#define BB_STAT_IN(n) do {} while(0)
+#define BB_STAT_OUT(n) do {} while(0)
+#define BB_STAT_OVERFLOW() do {} while(0)
+#define BB_STAT_UNDERFLOW() do {} while(0)
 #endif
-#include "ByteBuffer.h"
 
 ByteBuffer::ByteBuffer(){
+	data = 0;
+	capacity = 0;
+	position = 0;
+	length = 0;
+	ownsData = false;
+	overwrite = false;
+	overwriteCount = 0;
+	clearStats();
+}
 
+ByteBuffer::ByteBuffer(byte* storage, unsigned int buf_length){
+	ownsData = false;
+	overwrite = false;
+	overwriteCount = 0;
+	clearStats();
+	init(storage, buf_length);
 }
 
-void ByteBuffer::init(unsigned int buf_length){
-	data = (byte*)malloc(sizeof(byte)*buf_length);
+bool ByteBuffer::init(unsigned int buf_length){
+	byte* storage = (byte*)malloc(sizeof(byte)*buf_length);
+	if(storage == 0 || !init(storage, buf_length)){
+		free(storage);
+		return false;
+	}
+	ownsData = true;
+	return true;
+}
+
+bool ByteBuffer::init(byte* storage, unsigned int buf_length){
+	if(storage == 0 || buf_length == 0){
+		data = 0;
+		capacity = 0;
+		position = 0;
+		length = 0;
+		return false;
+	}
+	data = storage;
 	capacity = buf_length;
 	position = 0;
 	length = 0;
+	ownsData = false;
+	overwriteCount = 0;
+	return true;
 }
 
 void ByteBuffer::deAllocate(){
-	free(data);
+	if(ownsData)
+		free(data);
+	data = 0;
+	capacity = 0;
+	position = 0;
+	length = 0;
+	ownsData = false;
 }
 
 void ByteBuffer::clear(){
@@ -40,6 +87,26 @@ int ByteBuffer::getCapacity(){
 	return capacity;
 }
 
+void ByteBuffer::setOverwrite(bool enable){
+	overwrite = enable;
+}
+
+unsigned long ByteBuffer::getOverwriteCount(){
+	return overwriteCount;
+}
+
+void ByteBuffer::clearOverwriteCount(){
+	overwriteCount = 0;
+}
+
+void ByteBuffer::getStats(ByteBufferStats& out){
+	out = stats;
+}
+
+void ByteBuffer::clearStats(){
+	memset(&stats, 0, sizeof(stats));
+}
+
 byte ByteBuffer::peek(unsigned int index){
 	byte b = data[(position+index)%capacity];
 	return b;
@@ -51,9 +118,19 @@ int ByteBuffer::put(byte in){
 		data[(position+length) % capacity] = in;
 		// increment the length
 		length++;
+		BB_STAT_IN(1);
+		return 1;
+	}
+	if(overwrite && capacity > 0){
+		// buffer is full, the oldest byte is replaced by the new one
+		data[position] = in;
+		position = (position+1)%capacity;
+		overwriteCount++;
+		BB_STAT_IN(1);
 		return 1;
 	}
 	// return failure
+	BB_STAT_OVERFLOW();
 	return 0;
 }
 
@@ -67,9 +144,11 @@ int ByteBuffer::putInFront(byte in){
 		data[position] = in;
 		// increment the length
 		length++;
+		BB_STAT_IN(1);
 		return 1;
 	}
 	// return failure
+	BB_STAT_OVERFLOW();
 	return 0;
 }
 
@@ -82,6 +161,10 @@ byte ByteBuffer::get(){
 		// move index down and decrement length
 		position = (position+1)%capacity;
 		length--;
+		BB_STAT_OUT(1);
+	}
+	else{
+		BB_STAT_UNDERFLOW();
 	}
 
 	return b;
@@ -92,124 +175,388 @@ byte ByteBuffer::getFromBack(){
 	if(length > 0){
 		b = data[(position+length-1)%capacity];
 		length--;
+		BB_STAT_OUT(1);
+	}
+	else{
+		BB_STAT_UNDERFLOW();
 	}
 
 	return b;
 }
 
 //
-// Ints
+// Multi-byte values
+//
+// The value is first encoded into a small array with shifts, which is byte
+// order independent and lets the compiler merge the stores into a word
+// store (plus byte swap) where the target allows it. The array is then
+// copied into the ring with a single space check.
+//
+
+static inline void storeUInt16LE(byte* p, uint16_t v){
+	p[0] = (byte)v;
+	p[1] = (byte)(v >> 8);
+}
+
+static inline void storeUInt16BE(byte* p, uint16_t v){
+	p[0] = (byte)(v >> 8);
+	p[1] = (byte)v;
+}
+
+static inline void storeUInt32LE(byte* p, uint32_t v){
+	p[0] = (byte)v;
+	p[1] = (byte)(v >> 8);
+	p[2] = (byte)(v >> 16);
+	p[3] = (byte)(v >> 24);
+}
+
+static inline void storeUInt32BE(byte* p, uint32_t v){
+	p[0] = (byte)(v >> 24);
+	p[1] = (byte)(v >> 16);
+	p[2] = (byte)(v >> 8);
+	p[3] = (byte)v;
+}
+
+static inline uint16_t loadUInt16LE(const byte* p){
+	return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint16_t loadUInt16BE(const byte* p){
+	return ((uint16_t)p[0] << 8) | (uint16_t)p[1];
+}
+
+static inline uint32_t loadUInt32LE(const byte* p){
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t loadUInt32BE(const byte* p){
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint32_t floatToBits(float in){
+	uint32_t bits;
+	memcpy(&bits, &in, sizeof(bits));
+	return bits;
+}
+
+static inline float bitsToFloat(uint32_t bits){
+	float out;
+	memcpy(&out, &bits, sizeof(out));
+	return out;
+}
+
+inline int ByteBuffer::putValue(const byte* in, unsigned int n){
+	if(capacity - length < n){
+		if(!overwrite || capacity < n){
+			BB_STAT_OVERFLOW();
+			return 0;
+		}
+		// drop just enough of the oldest bytes to make room
+		unsigned int drop = n - (capacity - length);
+		overwriteCount += drop;
+		advance(drop);
+	}
+	unsigned int end = (position+length) % capacity;
+	if(end + n <= capacity){
+		memcpy(data+end, in, n);
+	}
+	else{
+		for(unsigned int i=0; i<n; i++){
+			data[end] = in[i];
+			if(++end == capacity)
+				end = 0;
+		}
+	}
+	length += n;
+	BB_STAT_IN(n);
+	return 1;
+}
+
+inline int ByteBuffer::putValueInFront(const byte* in, unsigned int n){
+	if(capacity - length < n){
+		BB_STAT_OVERFLOW();
+		return 0;
+	}
+	position = (position + capacity - n) % capacity;
+	length += n;
+	BB_STAT_IN(n);
+	if(position + n <= capacity){
+		memcpy(data+position, in, n);
+	}
+	else{
+		unsigned int index = position;
+		for(unsigned int i=0; i<n; i++){
+			data[index] = in[i];
+			if(++index == capacity)
+				index = 0;
+		}
+	}
+	return 1;
+}
+
+inline bool ByteBuffer::getValue(byte* out, unsigned int n){
+	if(length < n){
+		BB_STAT_UNDERFLOW();
+		return false;
+	}
+	peek(out, 0, n);
+	consume(n);
+	return true;
+}
+
+inline bool ByteBuffer::getValueFromBack(byte* out, unsigned int n){
+	if(length < n){
+		BB_STAT_UNDERFLOW();
+		return false;
+	}
+	peek(out, length-n, n);
+	length -= n;
+	BB_STAT_OUT(n);
+	return true;
+}
+
+int ByteBuffer::putUInt16LE(uint16_t in){
+	byte b[2];
+	storeUInt16LE(b, in);
+	return putValue(b, 2);
+}
+
+int ByteBuffer::putUInt16BE(uint16_t in){
+	byte b[2];
+	storeUInt16BE(b, in);
+	return putValue(b, 2);
+}
+
+int ByteBuffer::putUInt32LE(uint32_t in){
+	byte b[4];
+	storeUInt32LE(b, in);
+	return putValue(b, 4);
+}
+
+int ByteBuffer::putUInt32BE(uint32_t in){
+	byte b[4];
+	storeUInt32BE(b, in);
+	return putValue(b, 4);
+}
+
+int ByteBuffer::putFloatLE(float in){
+	return putUInt32LE(floatToBits(in));
+}
+
+int ByteBuffer::putFloatBE(float in){
+	return putUInt32BE(floatToBits(in));
+}
+
+uint16_t ByteBuffer::getUInt16LE(){
+	byte b[2];
+	if(!getValue(b, 2))
+		return 0;
+	return loadUInt16LE(b);
+}
+
+uint16_t ByteBuffer::getUInt16BE(){
+	byte b[2];
+	if(!getValue(b, 2))
+		return 0;
+	return loadUInt16BE(b);
+}
+
+uint32_t ByteBuffer::getUInt32LE(){
+	byte b[4];
+	if(!getValue(b, 4))
+		return 0;
+	return loadUInt32LE(b);
+}
+
+uint32_t ByteBuffer::getUInt32BE(){
+	byte b[4];
+	if(!getValue(b, 4))
+		return 0;
+	return loadUInt32BE(b);
+}
+
+float ByteBuffer::getFloatLE(){
+	return bitsToFloat(getUInt32LE());
+}
+
+float ByteBuffer::getFloatBE(){
+	return bitsToFloat(getUInt32BE());
+}
+
+//
+// Ints, stored as 16 bit big-endian
 //
 
 int ByteBuffer::putIntInFront(int in){
-    byte *pointer = (byte *)&in;
-	putInFront(pointer[0]);	
-	putInFront(pointer[1]);	
+	byte b[2];
+	storeUInt16BE(b, (uint16_t)in);
+	return putValueInFront(b, 2);
 }
 
 int ByteBuffer::putInt(int in){
-    byte *pointer = (byte *)&in;
-	put(pointer[1]);	
-	put(pointer[0]);	
+	return putUInt16BE((uint16_t)in);
 }
 
-
 int ByteBuffer::getInt(){
-	int ret;
-    byte *pointer = (byte *)&ret;
-	pointer[1] = get();
-	pointer[0] = get();
-	return ret;
+	return (int16_t)getUInt16BE();
 }
 
 int ByteBuffer::getIntFromBack(){
-	int ret;
-    byte *pointer = (byte *)&ret;
-	pointer[0] = getFromBack();
-	pointer[1] = getFromBack();
-	return ret;
+	byte b[2];
+	if(!getValueFromBack(b, 2))
+		return 0;
+	return (int16_t)loadUInt16BE(b);
 }
 
 //
-// Longs
+// Longs, stored as 32 bit big-endian
 //
 
 int ByteBuffer::putLongInFront(long in){
-    byte *pointer = (byte *)&in;
-	putInFront(pointer[0]);	
-	putInFront(pointer[1]);	
-	putInFront(pointer[2]);	
-	putInFront(pointer[3]);	
+	byte b[4];
+	storeUInt32BE(b, (uint32_t)in);
+	return putValueInFront(b, 4);
 }
 
 int ByteBuffer::putLong(long in){
-    byte *pointer = (byte *)&in;
-	put(pointer[3]);	
-	put(pointer[2]);	
-	put(pointer[1]);	
-	put(pointer[0]);	
+	return putUInt32BE((uint32_t)in);
 }
 
-
 long ByteBuffer::getLong(){
-	long ret;
-    byte *pointer = (byte *)&ret;
-	pointer[3] = get();
-	pointer[2] = get();
-	pointer[1] = get();
-	pointer[0] = get();
-	return ret;
+	return (int32_t)getUInt32BE();
 }
 
 long ByteBuffer::getLongFromBack(){
-	long ret;
-    byte *pointer = (byte *)&ret;
-	pointer[0] = getFromBack();
-	pointer[1] = getFromBack();
-	pointer[2] = getFromBack();
-	pointer[3] = getFromBack();
-	return ret;
+	byte b[4];
+	if(!getValueFromBack(b, 4))
+		return 0;
+	return (int32_t)loadUInt32BE(b);
 }
 
-
 //
-// Floats
+// Floats, stored as 32 bit big-endian
 //
 
 int ByteBuffer::putFloatInFront(float in){
-    byte *pointer = (byte *)&in;
-	putInFront(pointer[0]);	
-	putInFront(pointer[1]);	
-	putInFront(pointer[2]);	
-	putInFront(pointer[3]);	
+	byte b[4];
+	storeUInt32BE(b, floatToBits(in));
+	return putValueInFront(b, 4);
 }
 
 int ByteBuffer::putFloat(float in){
-    byte *pointer = (byte *)&in;
-	put(pointer[3]);	
-	put(pointer[2]);	
-	put(pointer[1]);	
-	put(pointer[0]);	
+	return putFloatBE(in);
 }
 
 float ByteBuffer::getFloat(){
-	float ret;
-    byte *pointer = (byte *)&ret;
-	pointer[3] = get();
-	pointer[2] = get();
-	pointer[1] = get();
-	pointer[0] = get();
-	return ret;
+	return getFloatBE();
 }
 
 float ByteBuffer::getFloatFromBack(){
-	float ret;
-    byte *pointer = (byte *)&ret;
-	pointer[0] = getFromBack();
-	pointer[1] = getFromBack();
-	pointer[2] = getFromBack();
-	pointer[3] = getFromBack();
-	return ret;
+	byte b[4];
+	if(!getValueFromBack(b, 4))
+		return 0;
+	return bitsToFloat(loadUInt32BE(b));
 }
 
+//
+// Bulk
+//
+
+unsigned int ByteBuffer::write(const byte* in, unsigned int n){
+	unsigned int space = capacity - length;
+	unsigned int requested = n;
+	if(overwrite && capacity > 0 && n > space){
+		// only the newest capacity bytes can be kept, drop enough old ones to make room
+		if(n > capacity){
+			overwriteCount += n - capacity;
+			in += n - capacity;
+			n = capacity;
+		}
+		overwriteCount += n - space;
+		advance(n - space);
+		space = n;
+	}
+	if(n > space)
+		n = space;
+	if(n < requested)
+		BB_STAT_OVERFLOW();
+	if(n == 0)
+		return 0;
+	unsigned int end = (position+length) % capacity;
+	unsigned int first = capacity - end;
+	if(first > n)
+		first = n;
+	memcpy(data+end, in, first);
+	memcpy(data, in+first, n-first);
+	length += n;
+	BB_STAT_IN(n);
+	return n;
+}
+
+unsigned int ByteBuffer::peek(byte* out, unsigned int offset, unsigned int n){
+	if(offset >= length)
+		return 0;
+	if(n > length-offset)
+		n = length-offset;
+	unsigned int start = (position+offset) % capacity;
+	unsigned int first = capacity - start;
+	if(first > n)
+		first = n;
+	memcpy(out, data+start, first);
+	memcpy(out+first, data, n-first);
+	return n;
+}
+
+unsigned int ByteBuffer::read(byte* out, unsigned int n){
+	if(n > 0 && length == 0)
+		BB_STAT_UNDERFLOW();
+	n = peek(out, 0, n);
+	consume(n);
+	return n;
+}
 
+//
+// Zero copy
+//
+
+unsigned int ByteBuffer::getReadRegion(byte** region){
+	*region = data + position;
+	if(position + length > capacity)
+		return capacity - position;
+	return length;
+}
+
+void ByteBuffer::consume(unsigned int n){
+	if(n > length)
+		n = length;
+	advance(n);
+	BB_STAT_OUT(n);
+}
+
+// Drops n stored bytes from the front without counting them as read
+void ByteBuffer::advance(unsigned int n){
+	// nothing to drop, also keeps a buffer without storage from dividing by 0
+	if(n == 0)
+		return;
+	position = (position+n) % capacity;
+	length -= n;
+}
+
+unsigned int ByteBuffer::getWriteRegion(byte** region){
+	unsigned int end = position + length;
+	if(end >= capacity){
+		// free space is a single block in front of position
+		end -= capacity;
+		*region = data + end;
+		return position - end;
+	}
+	*region = data + end;
+	return capacity - end;
+}
+
+void ByteBuffer::commit(unsigned int n){
+	if(n > capacity - length)
+		n = capacity - length;
+	length += n;
+	BB_STAT_IN(n);
+}
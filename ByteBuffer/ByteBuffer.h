@@ -7,18 +7,46 @@
 #ifndef ByteBuffer_h
 #define ByteBuffer_h
 
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// Uncomment to track peak occupancy, byte counts, overflows and underflows (see getStats).
+// Only the updates are compiled out, the class layout is the same either way.
+//#define BYTEBUFFER_STATS
+
+struct ByteBufferStats
+{
+	unsigned int peakSize;		// largest number of bytes stored at once
+	unsigned long bytesIn;		// bytes successfully put
+	unsigned long bytesOut;		// bytes removed by get/read/consume
+	unsigned long overflows;	// puts that failed or were truncated because the buffer was full
+	unsigned long underflows;	// gets made while the buffer held too few bytes
+};
+
 class ByteBuffer
 {
 public:
 	ByteBuffer();
 
+	// Creates a buffer that uses the caller supplied storage (e.g. a static array), no init call is needed
+	ByteBuffer(byte* storage, unsigned int buf_size);
+
 	// This method initializes the datastore of the buffer to a certain sizem the buffer should NOT be used before this call is made
-	void init(unsigned int buf_size);
+	// Returns false if the datastore could not be allocated
+	bool init(unsigned int buf_size);
+
+	// This method initializes the buffer to use caller supplied storage instead of the heap
+	// Returns false if storage is null or buf_size is 0
+	bool init(byte* storage, unsigned int buf_size);
 
 	// This method resets the buffer into an original state (with no data)	
 	void clear();
 
 	// This releases resources for this buffer, after this has been called the buffer should NOT be used
+	// Caller supplied storage is not freed
 	void deAllocate();
 
 	// Returns how much space is left in the buffer for more data
@@ -27,6 +55,17 @@ public:
 	// Returns the maximum capacity of the buffer
 	int getCapacity();
 
+	// Selects what put/write do when the buffer is full: drop the new data (default) or overwrite the oldest data
+	void setOverwrite(bool enable);
+
+	// Returns how many bytes have been overwritten (lost) since init or the last clearOverwriteCount
+	unsigned long getOverwriteCount();
+	void clearOverwriteCount();
+
+	// Copies the statistics into stats (all zero unless BYTEBUFFER_STATS is defined)
+	void getStats(ByteBufferStats& stats);
+	void clearStats();
+
 	// This method returns the byte that is located at index in the buffer but doesn't modify the buffer like the get methods (doesn't remove the retured byte from the buffer)
 	byte peek(unsigned int index);
 
@@ -36,6 +75,8 @@ public:
 	int putInFront(byte in);
 	int put(byte in);
 
+	// The int, long and float methods store values big-endian (most significant byte first).
+	// Multi-byte puts check the space once for the whole value and return 0, storing nothing, if it doesn't fit.
 	int putIntInFront(int in);
 	int putInt(int in);
 
@@ -45,6 +86,14 @@ public:
 	int putFloatInFront(float in);
 	int putFloat(float in);
 
+	// Explicit byte order, LE = least significant byte first, BE = most significant byte first
+	int putUInt16LE(uint16_t in);
+	int putUInt16BE(uint16_t in);
+	int putUInt32LE(uint32_t in);
+	int putUInt32BE(uint32_t in);
+	int putFloatLE(float in);
+	int putFloatBE(float in);
+
 	//
 	// Get methods, either a regular get from front or from back
 	// 
@@ -60,12 +109,50 @@ public:
 	float getFloat();	
 	float getFloatFromBack();	
 
+	// Multi-byte gets return 0, removing nothing, if the buffer holds fewer bytes than the value needs
+	uint16_t getUInt16LE();
+	uint16_t getUInt16BE();
+	uint32_t getUInt32LE();
+	uint32_t getUInt32BE();
+	float getFloatLE();
+	float getFloatBE();
+
+	//
+	// Bulk methods, copy up to n bytes in at most two memcpy calls and return the number of bytes transferred
+	// 
+	unsigned int write(const byte* in, unsigned int n);
+	unsigned int read(byte* out, unsigned int n);
+	unsigned int peek(byte* out, unsigned int offset, unsigned int n);
+
+	//
+	// Zero copy methods, expose the largest contiguous readable/writable region of the storage.
+	// After using the region call consume/commit with the number of bytes actually read/written.
+	// 
+	unsigned int getReadRegion(byte** region);
+	void consume(unsigned int n);
+
+	unsigned int getWriteRegion(byte** region);
+	void commit(unsigned int n);
+
 private:
 	byte* data;
 
 	unsigned int capacity;
 	unsigned int position;
 	unsigned int length;
+
+	bool ownsData;
+
+	bool overwrite;
+	unsigned long overwriteCount;
+
+	ByteBufferStats stats;
+
+	void advance(unsigned int n);
+	int putValue(const byte* in, unsigned int n);
+	int putValueInFront(const byte* in, unsigned int n);
+	bool getValue(byte* out, unsigned int n);
+	bool getValueFromBack(byte* out, unsigned int n);
 };
 
 #endif
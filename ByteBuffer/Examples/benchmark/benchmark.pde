@@ -0,0 +1,66 @@
+// Compares the cost per byte of ByteBuffer (modulo indexing) with
+// FixedByteBuffer (power of two capacity, mask indexing).
+#include "ByteBuffer.h"
+#include "FixedByteBuffer.h"
+
+#define BUFFER_SIZE 64
+#define NUM_PASSES 200
+
+ByteBuffer buffer;
+FixedByteBuffer<BUFFER_SIZE> fixedBuffer;
+volatile byte sink;
+
+void setup() {
+    Serial.begin(115200);
+    buffer.init(BUFFER_SIZE);
+}
+
+void printResult(const char *name, unsigned long dt) {
+    float cycles = (float) dt*(F_CPU/1000000UL)/(2.0*NUM_PASSES*BUFFER_SIZE);
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(cycles);
+    Serial.println(" cycles per put/get");
+}
+
+void loop() {
+    unsigned long t0;
+    unsigned long dt;
+
+    // Offset the start so that the indices wrap during the test
+    buffer.clear();
+    fixedBuffer.clear();
+    for (int i=0; i<BUFFER_SIZE/2; i++) {
+        buffer.put(0);
+        buffer.get();
+        fixedBuffer.put(0);
+        fixedBuffer.get();
+    }
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        for (int i=0; i<BUFFER_SIZE; i++) {
+            buffer.put((byte) i);
+        }
+        for (int i=0; i<BUFFER_SIZE; i++) {
+            sink = buffer.get();
+        }
+    }
+    dt = micros() - t0;
+    printResult("ByteBuffer     ", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        for (int i=0; i<BUFFER_SIZE; i++) {
+            fixedBuffer.put((byte) i);
+        }
+        for (int i=0; i<BUFFER_SIZE; i++) {
+            sink = fixedBuffer.get();
+        }
+    }
+    dt = micros() - t0;
+    printResult("FixedByteBuffer", dt);
+
+    Serial.println();
+    delay(2000);
+}
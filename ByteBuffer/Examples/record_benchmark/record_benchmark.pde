@@ -0,0 +1,77 @@
+// Compares records/sec for a timestamp plus 8 channel sample stored with
+// ByteBuffer putLong/putInt calls and with RecordRing.
+#include "ByteBuffer.h"
+#include "RecordRing.h"
+
+#define NUM_CHANNELS 8
+#define RING_SIZE 16
+#define NUM_PASSES 100
+
+struct Sample {
+    unsigned long timestamp;
+    int value[NUM_CHANNELS];
+};
+
+ByteBuffer buffer;
+RecordRing<Sample,RING_SIZE> ring;
+Sample sample;
+volatile int sink;
+
+void setup() {
+    Serial.begin(115200);
+    buffer.init(RING_SIZE*sizeof(Sample));
+    for (int j=0; j<NUM_CHANNELS; j++) {
+        sample.value[j] = j;
+    }
+}
+
+void printResult(const char *name, unsigned long dt) {
+    float rate = (1.0e6*NUM_PASSES*RING_SIZE)/dt;
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(rate);
+    Serial.println(" records/sec");
+}
+
+void loop() {
+    unsigned long t0;
+    unsigned long dt;
+    Sample out;
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        for (int i=0; i<RING_SIZE; i++) {
+            sample.timestamp = i;
+            buffer.putLong(sample.timestamp);
+            for (int j=0; j<NUM_CHANNELS; j++) {
+                buffer.putInt(sample.value[j]);
+            }
+        }
+        for (int i=0; i<RING_SIZE; i++) {
+            out.timestamp = buffer.getLong();
+            for (int j=0; j<NUM_CHANNELS; j++) {
+                out.value[j] = buffer.getInt();
+            }
+            sink = out.value[NUM_CHANNELS-1];
+        }
+    }
+    dt = micros() - t0;
+    printResult("ByteBuffer", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        for (int i=0; i<RING_SIZE; i++) {
+            sample.timestamp = i;
+            ring.push(sample);
+        }
+        for (int i=0; i<RING_SIZE; i++) {
+            ring.pop(out);
+            sink = out.value[NUM_CHANNELS-1];
+        }
+    }
+    dt = micros() - t0;
+    printResult("RecordRing", dt);
+
+    Serial.println();
+    delay(2000);
+}
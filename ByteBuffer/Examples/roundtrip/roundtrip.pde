@@ -0,0 +1,84 @@
+// Round trips every multi-byte type through a ByteBuffer starting at every
+// possible wrap position and reports any mismatch.
+#include "ByteBuffer.h"
+
+#define BUFFER_SIZE 11
+
+ByteBuffer buffer;
+int failures;
+
+void setup() {
+    Serial.begin(115200);
+    buffer.init(BUFFER_SIZE);
+}
+
+void check(bool ok, const char *name, int start) {
+    if (!ok) {
+        failures++;
+        Serial.print("FAIL ");
+        Serial.print(name);
+        Serial.print(" start = ");
+        Serial.println(start,DEC);
+    }
+}
+
+void reset(int start) {
+    buffer.clear();
+    for (int i=0; i<start; i++) {
+        buffer.put(0);
+        buffer.get();
+    }
+}
+
+void loop() {
+    failures = 0;
+    for (int start=0; start<BUFFER_SIZE; start++) {
+        reset(start);
+        buffer.putUInt16LE(0x1234);
+        check(buffer.getUInt16LE() == 0x1234, "UInt16LE", start);
+
+        reset(start);
+        buffer.putUInt16BE(0x1234);
+        check(buffer.getUInt16BE() == 0x1234, "UInt16BE", start);
+
+        reset(start);
+        buffer.putUInt32LE(0x12345678UL);
+        check(buffer.getUInt32LE() == 0x12345678UL, "UInt32LE", start);
+
+        reset(start);
+        buffer.putUInt32BE(0x12345678UL);
+        check(buffer.getUInt32BE() == 0x12345678UL, "UInt32BE", start);
+
+        reset(start);
+        buffer.putFloatLE(-3.25);
+        check(buffer.getFloatLE() == -3.25, "FloatLE", start);
+
+        reset(start);
+        buffer.putFloatBE(-3.25);
+        check(buffer.getFloatBE() == -3.25, "FloatBE", start);
+
+        reset(start);
+        buffer.putInt(-1234);
+        buffer.putLong(-123456789L);
+        buffer.putFloat(1.5);
+        check(buffer.putInt(1) == 0, "full", start);
+        check(buffer.getInt() == -1234, "Int", start);
+        check(buffer.getLong() == -123456789L, "Long", start);
+        check(buffer.getFloat() == 1.5, "Float", start);
+
+        reset(start);
+        buffer.putIntInFront(-7);
+        buffer.putLongInFront(70000L);
+        check(buffer.getLong() == 70000L, "LongInFront", start);
+        check(buffer.getInt() == -7, "IntInFront", start);
+
+        reset(start);
+        buffer.putInt(5);
+        buffer.putLong(-6);
+        check(buffer.getLongFromBack() == -6, "LongFromBack", start);
+        check(buffer.getIntFromBack() == 5, "IntFromBack", start);
+    }
+    Serial.print("failures = ");
+    Serial.println(failures,DEC);
+    delay(2000);
+}
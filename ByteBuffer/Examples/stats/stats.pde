@@ -0,0 +1,41 @@
+// Prints ByteBuffer statistics as a python dictionary using DictPrinter.
+// Uncomment BYTEBUFFER_STATS in ByteBuffer.h for non-zero values.
+#include "Streaming.h"
+#include "DictPrinter.h"
+#include "ByteBuffer.h"
+
+#define BUFFER_SIZE 32
+
+ByteBuffer buffer;
+DictPrinter dprint = DictPrinter();
+
+void setup() {
+    Serial.begin(115200);
+    buffer.init(BUFFER_SIZE);
+}
+
+void printStats() {
+    ByteBufferStats stats;
+    buffer.getStats(stats);
+    dprint.start();
+    dprint.addIntItem("capacity", buffer.getCapacity());
+    dprint.addLongItem("peakSize", stats.peakSize);
+    dprint.addLongItem("bytesIn", stats.bytesIn);
+    dprint.addLongItem("bytesOut", stats.bytesOut);
+    dprint.addLongItem("overflows", stats.overflows);
+    dprint.addLongItem("underflows", stats.underflows);
+    dprint.stop();
+}
+
+void loop() {
+    // Fill at a varying rate and drain at a fixed one
+    int n = random(0,12);
+    for (int i=0; i<n; i++) {
+        buffer.put((byte) i);
+    }
+    for (int i=0; i<5; i++) {
+        buffer.get();
+    }
+    printStats();
+    delay(500);
+}
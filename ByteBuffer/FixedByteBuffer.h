@@ -0,0 +1,101 @@
+/*
+  FixedByteBuffer.h - A compile time sized circular buffer for Arduino.
+  The capacity N must be a power of two so that indices are wrapped with a
+  mask instead of the % operator (a software division on AVR).
+ */
+
+#ifndef FixedByteBuffer_h
+#define FixedByteBuffer_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+template<unsigned int N>
+class FixedByteBuffer
+{
+	// Fails to compile (negative array size) when N is not a power of two
+	typedef char capacity_must_be_power_of_two[(N != 0 && (N & (N-1)) == 0) ? 1 : -1];
+
+public:
+	FixedByteBuffer(){
+		clear();
+	}
+
+	// This method resets the buffer into an original state (with no data)
+	void clear(){
+		position = 0;
+		length = 0;
+	}
+
+	// Returns how many bytes are stored in the buffer
+	int getSize(){
+		return length;
+	}
+
+	// Returns the maximum capacity of the buffer
+	int getCapacity(){
+		return N;
+	}
+
+	// This method returns the byte that is located at index in the buffer but doesn't remove it
+	byte peek(unsigned int index){
+		return data[(position+index) & MASK];
+	}
+
+	//
+	// Put methods, either a regular put in back or put in front
+	//
+	int put(byte in){
+		if(length < N){
+			data[(position+length) & MASK] = in;
+			length++;
+			return 1;
+		}
+		return 0;
+	}
+
+	int putInFront(byte in){
+		if(length < N){
+			position = (position-1) & MASK;
+			data[position] = in;
+			length++;
+			return 1;
+		}
+		return 0;
+	}
+
+	//
+	// Get methods, either a regular get from front or from back
+	//
+	byte get(){
+		byte b = 0;
+		if(length > 0){
+			b = data[position];
+			position = (position+1) & MASK;
+			length--;
+		}
+		return b;
+	}
+
+	byte getFromBack(){
+		byte b = 0;
+		if(length > 0){
+			b = data[(position+length-1) & MASK];
+			length--;
+		}
+		return b;
+	}
+
+private:
+	enum {MASK = N-1};
+
+	byte data[N];
+
+	unsigned int position;
+	unsigned int length;
+};
+
+#endif
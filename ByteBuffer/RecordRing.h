@@ -0,0 +1,81 @@
+/*
+  RecordRing.h - A circular buffer of fixed size records for Arduino.
+  Whole records are copied in and out of slots so there is no per byte
+  packing or byte order shuffling, and records are addressed by index.
+ */
+
+#ifndef RecordRing_h
+#define RecordRing_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+template<typename T, unsigned int N>
+class RecordRing
+{
+public:
+	RecordRing(){
+		clear();
+	}
+
+	// This method resets the ring into an original state (with no records)
+	void clear(){
+		position = 0;
+		length = 0;
+	}
+
+	// Returns how many records are stored in the ring
+	unsigned int getSize(){
+		return length;
+	}
+
+	// Returns the maximum number of records
+	unsigned int getCapacity(){
+		return N;
+	}
+
+	// Adds a record at the back of the ring, returns 0 if the ring is full
+	int push(const T& record){
+		if(length < N){
+			data[wrap(position+length)] = record;
+			length++;
+			return 1;
+		}
+		return 0;
+	}
+
+	// Removes the record at the front of the ring into record, returns 0 if the ring is empty
+	int pop(T& record){
+		if(length > 0){
+			record = data[position];
+			position = wrap(position+1);
+			length--;
+			return 1;
+		}
+		return 0;
+	}
+
+	// Returns a pointer to the record at index from the front without removing it, or 0 if there is no such record
+	T* peek(unsigned int index){
+		if(index < length){
+			return &data[wrap(position+index)];
+		}
+		return 0;
+	}
+
+private:
+	T data[N];
+
+	unsigned int position;
+	unsigned int length;
+
+	// index is always less than 2*N so a compare replaces the modulo
+	static unsigned int wrap(unsigned int index){
+		return (index >= N) ? index - N : index;
+	}
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+  SpscByteBuffer.cpp - A lock-free single-producer/single-consumer circular
+  buffer for Arduino.
+ */
+
+#include "SpscByteBuffer.h"
+
+SpscByteBuffer::SpscByteBuffer(){
+	data = 0;
+	bufSize = 0;
+	ownsData = false;
+	head = 0;
+	tail = 0;
+}
+
+bool SpscByteBuffer::init(unsigned int buf_size){
+	if(buf_size > 255)
+		return false;
+	byte* storage = (byte*)malloc(sizeof(byte)*(buf_size+1));
+	if(storage == 0 || !init(storage, buf_size+1)){
+		free(storage);
+		return false;
+	}
+	ownsData = true;
+	return true;
+}
+
+bool SpscByteBuffer::init(byte* storage, unsigned int buf_size){
+	head = 0;
+	tail = 0;
+	ownsData = false;
+	// the indices are single bytes
+	if(storage == 0 || buf_size < 2 || buf_size > 256){
+		data = 0;
+		bufSize = 0;
+		return false;
+	}
+	data = storage;
+	bufSize = buf_size;
+	return true;
+}
+
+void SpscByteBuffer::deAllocate(){
+	if(ownsData)
+		free(data);
+	data = 0;
+	bufSize = 0;
+	ownsData = false;
+	head = 0;
+	tail = 0;
+}
+
+void SpscByteBuffer::clear(){
+	head = 0;
+	tail = 0;
+}
+
+int SpscByteBuffer::getSize(){
+	unsigned int h = head;
+	unsigned int t = tail;
+	if(h >= t)
+		return h - t;
+	return bufSize - t + h;
+}
+
+int SpscByteBuffer::getCapacity(){
+	return bufSize - 1;
+}
+
+int SpscByteBuffer::put(byte in){
+	unsigned int h = head;
+	unsigned int next = h + 1;
+	// >= so that a buffer without storage is always full
+	if(next >= bufSize)
+		next = 0;
+	if(next == tail){
+		// return failure, buffer is full
+		return 0;
+	}
+	data[h] = in;
+	// publish the byte before moving the head
+	SPSC_BARRIER();
+	head = next;
+	return 1;
+}
+
+byte SpscByteBuffer::get(){
+	byte b = 0;
+	unsigned int t = tail;
+	if(t != head){
+		SPSC_BARRIER();
+		b = data[t];
+		// the slot must be read before it is handed back to the producer
+		SPSC_BARRIER();
+		t++;
+		if(t == bufSize)
+			t = 0;
+		tail = t;
+	}
+	return b;
+}
+
+byte SpscByteBuffer::peek(unsigned int index){
+	unsigned int pos = tail + index;
+	SPSC_BARRIER();
+	if(pos >= bufSize)
+		pos -= bufSize;
+	return data[pos];
+}
@@ -0,0 +1,74 @@
+/*
+  SpscByteBuffer.h - A lock-free single-producer/single-consumer circular
+  buffer for Arduino. The producer (e.g. a USART or TWI interrupt handler)
+  only calls put() and the consumer (e.g. loop()) only calls get()/peek().
+  The indices are single bytes, which every core loads and stores 
+  atomically, so neither side ever disables interrupts. The capacity is 
+  limited to 255 bytes.
+ */
+
+#ifndef SpscByteBuffer_h
+#define SpscByteBuffer_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// Orders the data access against the index update. On AVR there is a single
+// core so a compiler barrier is enough, on hosts a full fence is used.
+#if defined(__AVR__)
+#define SPSC_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define SPSC_BARRIER() __sync_synchronize()
+#endif
+
+class SpscByteBuffer
+{
+public:
+	SpscByteBuffer();
+
+	// This method initializes the datastore of the buffer to a certain size, the buffer should NOT be used before this call is made
+	// Returns false if buf_size is more than 255 or the datastore could not be allocated
+	bool init(unsigned int buf_size);
+
+	// This method initializes the buffer to use caller supplied storage, one byte of it is kept free so the capacity is buf_size-1
+	// Returns false if storage is null or buf_size is less than 2 or more than 256
+	bool init(byte* storage, unsigned int buf_size);
+
+	// This method resets the buffer into an original state (with no data), only call it while neither side is active
+	void clear();
+
+	// This releases resources for this buffer, after this has been called the buffer should NOT be used
+	// Caller supplied storage is not freed
+	void deAllocate();
+
+	// Returns how many bytes are stored in the buffer
+	int getSize();
+
+	// Returns the maximum capacity of the buffer
+	int getCapacity();
+
+	// Producer side: adds a byte at the back of the buffer, returns 0 if the buffer is full
+	int put(byte in);
+
+	// Consumer side: removes and returns the byte at the front of the buffer (0 if empty)
+	byte get();
+
+	// Consumer side: returns the byte at index from the front without removing it
+	byte peek(unsigned int index);
+
+private:
+	byte* data;
+
+	// one slot is always kept free so that head == tail means empty
+	unsigned int bufSize;
+	bool ownsData;
+
+	// head is only written by the producer, tail only by the consumer
+	volatile uint8_t head;
+	volatile uint8_t tail;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef DictPrinter_h
 #define DictPrinter_h
 #include <stdarg.h>
+#include <stdint.h>
 
 #define DP_DOUBLE_PREC 12
 #define DP_STR_LEN 30
@@ -0,0 +1,66 @@
+// Measures getValue lookups per second for table sizes from 4 to 1024 
+// points, with scattered inputs and with a slowly varying input where the
+// segment hint helps.
+#include "Streaming.h"
+#include "LookupTable.h"
+
+// A 1024 point table needs 4 KB, boards with less RAM stop at 256 points
+#if defined(RAMEND) && (RAMEND < 0x1000)
+#define MAX_TABLE_SIZE 256
+#else
+#define MAX_TABLE_SIZE 1024
+#endif
+
+#define NUM_LOOKUPS 2000
+#define X_STEP 16
+
+int table[MAX_TABLE_SIZE][2];
+LookupTable lookup;
+volatile int sink;
+
+void setup() {
+    Serial.begin(115200);
+    for (int i=0; i<MAX_TABLE_SIZE; i++) {
+        table[i][0] = i*X_STEP;
+        table[i][1] = (i*i) % 1000;
+    }
+}
+
+// Returns lookups per second, stride is the change of x between lookups
+unsigned long run(unsigned int size, bool hint, int stride) {
+    int range = (size-1)*X_STEP;
+    int x = 0;
+    unsigned long t0;
+    unsigned long dt;
+
+    lookup.setTable(table, size);
+    lookup.setHint(hint);
+    t0 = micros();
+    for (int n=0; n<NUM_LOOKUPS; n++) {
+        sink = lookup.getValue(x);
+        x += stride;
+        if (x >= range) {
+            x -= range;
+        }
+    }
+    dt = micros() - t0;
+    if (dt == 0) {
+        // Faster than the timer resolution
+        dt = 1;
+    }
+    return (1000000UL*NUM_LOOKUPS)/dt;
+}
+
+void loop() {
+    Serial << "size, scattered, scattered+hint, slow, slow+hint (lookups/s)" << endl;
+    for (unsigned int size=4; size<=MAX_TABLE_SIZE; size*=2) {
+        int scattered = 7919 % ((size-1)*X_STEP);
+        Serial << _DEC(size) << ", ";
+        Serial << run(size, false, scattered) << ", ";
+        Serial << run(size, true, scattered) << ", ";
+        Serial << run(size, false, 1) << ", ";
+        Serial << run(size, true, 1) << endl;
+    }
+    Serial << endl;
+    delay(5000);
+}
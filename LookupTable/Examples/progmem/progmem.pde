@@ -0,0 +1,91 @@
+#include "Streaming.h"
+#include "LookupTable.h"
+
+// A 65 point square root curve, kept in flash so it uses no RAM
+#define TABLE_SIZE 65
+const int table[TABLE_SIZE][2] PROGMEM = {
+    {0, 0},
+    {16, 125},
+    {32, 177},
+    {48, 217},
+    {64, 250},
+    {80, 280},
+    {96, 306},
+    {112, 331},
+    {128, 354},
+    {144, 375},
+    {160, 395},
+    {176, 415},
+    {192, 433},
+    {208, 451},
+    {224, 468},
+    {240, 484},
+    {256, 500},
+    {272, 515},
+    {288, 530},
+    {304, 545},
+    {320, 559},
+    {336, 573},
+    {352, 586},
+    {368, 599},
+    {384, 612},
+    {400, 625},
+    {416, 637},
+    {432, 650},
+    {448, 661},
+    {464, 673},
+    {480, 685},
+    {496, 696},
+    {512, 707},
+    {528, 718},
+    {544, 729},
+    {560, 740},
+    {576, 750},
+    {592, 760},
+    {608, 771},
+    {624, 781},
+    {640, 791},
+    {656, 800},
+    {672, 810},
+    {688, 820},
+    {704, 829},
+    {720, 839},
+    {736, 848},
+    {752, 857},
+    {768, 866},
+    {784, 875},
+    {800, 884},
+    {816, 893},
+    {832, 901},
+    {848, 910},
+    {864, 919},
+    {880, 927},
+    {896, 935},
+    {912, 944},
+    {928, 952},
+    {944, 960},
+    {960, 968},
+    {976, 976},
+    {992, 984},
+    {1008, 992},
+    {1024, 1000}
+    };
+
+LookupTable lookup;
+
+void setup() {
+    bool rtnVal;
+    Serial.begin(9600);
+    rtnVal = lookup.setTable_P(table,TABLE_SIZE);
+    Serial << "setTable_P rtnVal = " << rtnVal << endl;
+}
+
+void loop() {
+    int y;
+    for (int x= -16; x<1100; x+=20) {
+       y = lookup.getValue(x);
+       Serial << "x = " << _DEC(x) << " y = " << _DEC(y) << endl;
+    }
+    Serial << endl;
+    delay(1000);
+}
@@ -0,0 +1,62 @@
+// Compares getValue with precomputed Q16 slopes against the map() based
+// interpolation: the number of results that differ and the cycles per lookup.
+#include "Streaming.h"
+#include "LookupTable.h"
+
+#define TABLE_SIZE 9
+int table[TABLE_SIZE][2] = {
+    {-1000, -3000},
+    {-600, -1210},
+    {-200, -215},
+    {0, 0},
+    {100, 333},
+    {350, 1024},
+    {700, 1790},
+    {1200, 2050},
+    {2000, 1500}
+    };
+long slopes[TABLE_SIZE-1];
+
+LookupTable mapLookup;
+LookupTable slopeLookup;
+volatile int sink;
+
+void setup() {
+    Serial.begin(115200);
+    mapLookup.setTable(table, TABLE_SIZE);
+    slopeLookup.setTable(table, TABLE_SIZE, slopes);
+    Serial << "usingSlopes = " << slopeLookup.usingSlopes() << endl;
+}
+
+// Cycles per lookup over every x in the table range
+float timeLookups(LookupTable &lookup) {
+    unsigned long t0;
+    unsigned long dt;
+    long num = 0;
+    t0 = micros();
+    for (int x=table[0][0]; x<=table[TABLE_SIZE-1][0]; x++) {
+        sink = lookup.getValue(x);
+        num++;
+    }
+    dt = micros() - t0;
+    return (float) dt*(F_CPU/1000000UL)/num;
+}
+
+void loop() {
+    int diffCount = 0;
+    int maxDiff = 0;
+    for (int x=table[0][0]-10; x<=table[TABLE_SIZE-1][0]+10; x++) {
+        int diff = abs(slopeLookup.getValue(x) - mapLookup.getValue(x));
+        if (diff != 0) {
+            diffCount++;
+        }
+        if (diff > maxDiff) {
+            maxDiff = diff;
+        }
+    }
+    Serial << "differing results: " << _DEC(diffCount) << ", max difference: " << _DEC(maxDiff) << endl;
+    Serial << "map():  " << timeLookups(mapLookup) << " cycles per lookup" << endl;
+    Serial << "slopes: " << timeLookups(slopeLookup) << " cycles per lookup" << endl;
+    Serial << endl;
+    delay(2000);
+}
@@ -0,0 +1,42 @@
+#include "Streaming.h"
+#include "LookupTableT.h"
+
+// Encoder counts (32 bit) to shaft angle in degrees
+#define ANGLE_TABLE_SIZE 4
+const LT_Point<long, float> angleTable[ANGLE_TABLE_SIZE] = {
+    {0, 0.0},
+    {40000, 90.5},
+    {80000, 181.0},
+    {160000, 360.0}
+    };
+
+// int table built and checked at compile time
+LT_CONSTEXPR LT_Point<int, int> table[] = {
+    {0, 0},     
+    {10, 20}, 
+    {20, 40}
+    };
+#if __cplusplus >= 201103L
+static_assert(lt_isMonotonic(table), "table x values must be sorted");
+#endif
+
+LookupTableT<long, float> angleLookup;
+LookupTableT<int, int> lookup(table);
+
+void setup() {
+    bool rtnVal;
+    Serial.begin(9600);
+    rtnVal = angleLookup.setTable(angleTable, ANGLE_TABLE_SIZE);
+    Serial << "setTable rtnVal = " << rtnVal << endl;
+}
+
+void loop() {
+    for (long count= -10000; count<=170000; count+=10000) {
+       Serial << "count = " << count << " angle = " << angleLookup.getValue(count) << endl;
+    }
+    for (int x= -10; x<30; x+=5) {
+       Serial << "x = " << _DEC(x) << " y = " << _DEC(lookup.getValue(x)) << endl;
+    }
+    Serial << endl;
+    delay(1000);
+}
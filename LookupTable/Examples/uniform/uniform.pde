@@ -0,0 +1,58 @@
+#include "Streaming.h"
+#include "LookupTable.h"
+#include "UniformLookupTable.h"
+
+// Calibration points every 256 counts starting at x = 0
+#define TABLE_SIZE 5
+#define X0 0
+#define STEP 256
+int yTable[TABLE_SIZE] = {0, 150, 320, 510, 720};
+
+// The same points for the general lookup table
+int table[TABLE_SIZE][2] = {
+    {0, 0},
+    {256, 150},
+    {512, 320},
+    {768, 510},
+    {1024, 720}
+    };
+
+UniformLookupTable uniform;
+LookupTable lookup;
+
+void setup() {
+    bool rtnVal;
+    Serial.begin(9600);
+    rtnVal = uniform.setTable(X0, STEP, yTable, TABLE_SIZE);
+    Serial << "setTable rtnVal = " << rtnVal << endl;
+    lookup.setTable(table, TABLE_SIZE);
+}
+
+void loop() {
+    int y;
+    unsigned long t0;
+    unsigned long dt;
+
+    for (int x= -64; x<1100; x+=50) {
+       y = uniform.getValue(x);
+       Serial << "x = " << _DEC(x) << " y = " << _DEC(y);
+       Serial << " (LookupTable y = " << _DEC(lookup.getValue(x)) << ")" << endl;
+    }
+
+    t0 = micros();
+    for (int x=0; x<1024; x++) {
+        y += uniform.getValue(x);
+    }
+    dt = micros() - t0;
+    Serial << "uniform: " << dt << " us per 1024 lookups" << endl;
+
+    t0 = micros();
+    for (int x=0; x<1024; x++) {
+        y += lookup.getValue(x);
+    }
+    dt = micros() - t0;
+    Serial << "lookup:  " << dt << " us per 1024 lookups (" << _DEC(y) << ")" << endl;
+
+    Serial << endl;
+    delay(1000);
+}
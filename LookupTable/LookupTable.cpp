@@ -1,44 +1,171 @@
 #include "LookupTable.h"
-#include "Streaming.h"
 
 LookupTable::LookupTable() {
     size = 0;
+    useHint = false;
+    lastSegment = 1;
+    progmem = false;
+    slopes = 0;
 }
 
-bool LookupTable::setTable(int _table[][2], unsigned int _size) {
-    bool rtnVal = true;
+bool LookupTable::setTable(int _table[][2], unsigned int _size, long *_slopes) {
+    bool rtnVal;
+    table = _table;
+    size = _size;
+    progmem = false;
+    rtnVal = checkTable();
+    setSlopes(rtnVal ? _slopes : 0);
+    return rtnVal;
+}
+
+// Same as setTable for a table stored in flash, e.g.
+// const int table[N][2] PROGMEM = {...};
+bool LookupTable::setTable_P(const int _table[][2], unsigned int _size, long *_slopes) {
+    bool rtnVal;
     table = _table;
     size = _size;
+    progmem = true;
+    rtnVal = checkTable();
+    setSlopes(rtnVal ? _slopes : 0);
+    return rtnVal;
+}
+
+bool LookupTable::checkTable() {
+    bool rtnVal = true;
+    lastSegment = 1;
     for (int i=1; i<size; i++) {
-        if (table[i-1][0] > table[i][0]) {
+        if (tableX(i-1) > tableX(i)) {
             rtnVal = false;
         }
     }
     return rtnVal;
 }
 
+// Program memory is only a separate address space on AVR, where int is 16
+// bits. Elsewhere flash is memory mapped and int may be wider than the word
+// pgm_read_word reads, so the table is read directly.
+#if defined(__AVR__)
+int LookupTable::tableX(unsigned int i) {
+    if (progmem) {
+        return (int) pgm_read_word(&table[i][0]);
+    }
+    else {
+        return table[i][0];
+    }
+}
+
+int LookupTable::tableY(unsigned int i) {
+    if (progmem) {
+        return (int) pgm_read_word(&table[i][1]);
+    }
+    else {
+        return table[i][1];
+    }
+}
+#else
+int LookupTable::tableX(unsigned int i) {
+    return table[i][0];
+}
+
+int LookupTable::tableY(unsigned int i) {
+    return table[i][1];
+}
+#endif
+
 
 int LookupTable::getValue(int x) {
     int rtnVal=0;
 
     // handle x values outside of range - return nearest end point value.
-    if (x <= table[0][0]) {
-        rtnVal = table[0][1];
+    if (x <= tableX(0)) {
+        rtnVal = tableY(0);
     }
-    else if (x >= table[size-1][0]) {
-        rtnVal = table[size-1][1];
+    else if (x >= tableX(size-1)) {
+        rtnVal = tableY(size-1);
     }
     else {
         // x value is inside table - interpolate
-        for (int i=1; i<size; i++) {
-            if ((x >= table[i-1][0]) && (x < table[i][0])) {
-                rtnVal = map(x,table[i-1][0], table[i][0], table[i-1][1], table[i][1]);
-                break;
-            }
+        unsigned int i = findSegment(x);
+        if (slopes != 0) {
+            long dy = (long) ((unsigned int) x - (unsigned int) tableX(i-1))*slopes[i-1];
+            // Rounds towards zero like map()
+            dy = (dy < 0) ? -(-dy >> 16) : (dy >> 16);
+            rtnVal = tableY(i-1) + dy;
+        }
+        else {
+            rtnVal = map(x, tableX(i-1), tableX(i), tableY(i-1), tableY(i));
         }
     }
     return rtnVal;
 }
 
+bool LookupTable::usingSlopes() {
+    return (slopes != 0);
+}
+
+// Fills _slopes[i-1] with the slope of segment i in Q16 fixed point, rounded
+// away from zero. Then (x - x[i-1])*slope >> 16 truncates to the same value 
+// as map() for segments up to 256 wide and is at most 1 off for wider ones.
+// The product fits in a long when |dy| < 32768 and dx < 65536, if any 
+// segment is steeper or wider the slopes are not used.
+void LookupTable::setSlopes(long *_slopes) {
+    slopes = 0;
+    if (_slopes == 0) {
+        return;
+    }
+    for (unsigned int i=1; i<size; i++) {
+        long dx = (long) tableX(i) - tableX(i-1);
+        long dy = (long) tableY(i) - tableY(i-1);
+        if ((dx > 65535L) || (dy > 32767L) || (dy < -32767L)) {
+            return;
+        }
+        if (dx == 0) {
+            // Never used, x values can't fall inside an empty segment
+            _slopes[i-1] = 0;
+        }
+        else if (dy < 0) {
+            _slopes[i-1] = -((-dy*65536L + dx - 1)/dx);
+        }
+        else {
+            _slopes[i-1] = (dy*65536L + dx - 1)/dx;
+        }
+    }
+    slopes = _slopes;
+}
+
+void LookupTable::setHint(bool enable) {
+    useHint = enable;
+}
+
+// Returns the index i of the segment table[i-1][0] <= x < table[i][0], x must
+// be inside the table.
+unsigned int LookupTable::findSegment(int x) {
+    if (useHint) {
+        unsigned int i = lastSegment;
+        if ((x >= tableX(i-1)) && (x < tableX(i))) {
+            return i;
+        }
+        if ((i < size-1) && (x >= tableX(i)) && (x < tableX(i+1))) {
+            lastSegment = i+1;
+            return i+1;
+        }
+    }
+
+    // Binary search for the first breakpoint greater than x
+    unsigned int lo = 1;
+    unsigned int hi = size-1;
+    while (lo < hi) {
+        unsigned int mid = lo + (hi-lo)/2;
+        if (x < tableX(mid)) {
+            hi = mid;
+        }
+        else {
+            lo = mid+1;
+        }
+    }
+    lastSegment = lo;
+    return lo;
+}
+
 
 
@@ -6,14 +6,34 @@
 #include "WProgram.h"
 #endif
 
+// Lookup table of int points, see LookupTableT.h for other x and y types
 class LookupTable {
     public:
         LookupTable();
         int getValue(int x);
-        bool setTable(int _table[][2], unsigned int _size);
+        // If _slopes (size-1 longs of RAM) is given the segment slopes are
+        // precomputed so that getValue needs one multiply instead of the
+        // divide in map(). usingSlopes() tells whether the table allowed it.
+        bool setTable(int _table[][2], unsigned int _size, long *_slopes=0);
+        // Reads the breakpoints directly from a table in program memory
+        bool setTable_P(const int _table[][2], unsigned int _size, long *_slopes=0);
+        bool usingSlopes();
+        // When enabled getValue first tries the segment of the previous
+        // lookup and the one after it before searching, which is faster for
+        // slowly varying inputs.
+        void setHint(bool enable);
     private:
         unsigned int size;
-        int (*table)[2];
+        const int (*table)[2];
+        bool progmem;
+        long *slopes;
+        bool useHint;
+        unsigned int lastSegment;
+        unsigned int findSegment(int x);
+        bool checkTable();
+        void setSlopes(long *_slopes);
+        int tableX(unsigned int i);
+        int tableY(unsigned int i);
 };
 
 #endif
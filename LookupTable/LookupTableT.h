@@ -0,0 +1,133 @@
+#ifndef LOOKUP_TABLE_T_H
+#define LOOKUP_TABLE_T_H
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#if __cplusplus >= 201103L
+#define LT_CONSTEXPR constexpr
+#else
+#define LT_CONSTEXPR
+#endif
+
+// Table point, tables are arrays of these sorted by x, e.g.
+// const LT_Point<long,float> table[] = {{0, 0.0}, {4096, 90.0}, ...};
+template<typename XType, typename YType>
+struct LT_Point {
+    XType x;
+    YType y;
+};
+
+template<typename T> struct LT_IsFloat { enum {value = 0}; };
+template<> struct LT_IsFloat<float> { enum {value = 1}; };
+template<> struct LT_IsFloat<double> { enum {value = 1}; };
+
+// Type the interpolation (x - x0)*(y1 - y0)/(x1 - x0) is computed in: long
+// when both types are at most 16 bits (the same as map()), long long for
+// wider integers, and floating point if either type is.
+enum {LT_CALC_LONG = 0, LT_CALC_LONG_LONG = 1, LT_CALC_Y = 2, LT_CALC_FLOAT = 3};
+
+template<typename XType, typename YType, int Calc =
+    LT_IsFloat<YType>::value ? LT_CALC_Y :
+    LT_IsFloat<XType>::value ? LT_CALC_FLOAT :
+    ((sizeof(XType) <= 2) && (sizeof(YType) <= 2)) ? LT_CALC_LONG : LT_CALC_LONG_LONG>
+struct LT_DefaultCalcType;
+
+template<typename XType, typename YType>
+struct LT_DefaultCalcType<XType, YType, LT_CALC_LONG> { typedef long Type; };
+template<typename XType, typename YType>
+struct LT_DefaultCalcType<XType, YType, LT_CALC_LONG_LONG> { typedef long long Type; };
+template<typename XType, typename YType>
+struct LT_DefaultCalcType<XType, YType, LT_CALC_Y> { typedef YType Type; };
+template<typename XType, typename YType>
+struct LT_DefaultCalcType<XType, YType, LT_CALC_FLOAT> { typedef float Type; };
+
+// Specialize for custom value types, e.g.
+// template<> struct LT_CalcType<long, Fixed> { typedef Fixed Type; };
+template<typename XType, typename YType>
+struct LT_CalcType : LT_DefaultCalcType<XType, YType> {};
+
+#if __cplusplus >= 201103L
+// Compile time check that the x values never decrease, e.g.
+// constexpr LT_Point<int,int> table[] = {...};
+// static_assert(lt_isMonotonic(table), "table x values must be sorted");
+// The range is split in halves so the recursion depth stays log2(size).
+template<typename XType, typename YType>
+constexpr bool lt_isMonotonic(const LT_Point<XType, YType> *table, unsigned int lo, unsigned int hi) {
+    return (hi - lo < 2) ? true :
+        (hi - lo == 2) ? (table[lo].x <= table[lo+1].x) :
+        (lt_isMonotonic(table, lo, (lo+hi)/2 + 1) && lt_isMonotonic(table, (lo+hi)/2, hi));
+}
+
+template<typename XType, typename YType, unsigned int N>
+constexpr bool lt_isMonotonic(const LT_Point<XType, YType> (&table)[N]) {
+    return lt_isMonotonic(table, 0, N);
+}
+#endif
+
+// Lookup table for any x and y types, with the same clamping and
+// interpolation as LookupTable (identical results for int tables). Tables
+// can be checked when they are set, or at compile time with lt_isMonotonic
+// and the constexpr constructor.
+template<typename XType, typename YType>
+class LookupTableT {
+    public:
+        typedef LT_Point<XType, YType> Point;
+        typedef typename LT_CalcType<XType, YType>::Type CalcType;
+
+        LT_CONSTEXPR LookupTableT() : table(0), size(0) {}
+
+        template<unsigned int N>
+        LT_CONSTEXPR LookupTableT(const Point (&_table)[N]) : table(_table), size(N) {}
+
+        // Returns false if the x values are not sorted
+        bool setTable(const Point *_table, unsigned int _size) {
+            bool rtnVal = true;
+            table = _table;
+            size = _size;
+            for (unsigned int i=1; i<size; i++) {
+                if (table[i].x < table[i-1].x) {
+                    rtnVal = false;
+                }
+            }
+            return rtnVal;
+        }
+
+        YType getValue(XType x) const {
+            // handle x values outside of range - return nearest end point value.
+            if (x <= table[0].x) {
+                return table[0].y;
+            }
+            if (x >= table[size-1].x) {
+                return table[size-1].y;
+            }
+
+            // x value is inside table - find the first breakpoint greater
+            // than x and interpolate
+            unsigned int lo = 1;
+            unsigned int hi = size-1;
+            while (lo < hi) {
+                unsigned int mid = lo + (hi-lo)/2;
+                if (x < table[mid].x) {
+                    hi = mid;
+                }
+                else {
+                    lo = mid+1;
+                }
+            }
+            const Point &p0 = table[lo-1];
+            const Point &p1 = table[lo];
+            CalcType dx = (CalcType) x - (CalcType) p0.x;
+            CalcType dy = (CalcType) p1.y - (CalcType) p0.y;
+            CalcType width = (CalcType) p1.x - (CalcType) p0.x;
+            return (YType) (dx*dy/width + (CalcType) p0.y);
+        }
+
+    private:
+        const Point *table;
+        unsigned int size;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "UniformLookupTable.h"
+
+UniformLookupTable::UniformLookupTable() {
+    size = 0;
+}
+
+// Returns false if step is 0 or the table is empty
+bool UniformLookupTable::setTable(int _x0, unsigned int _step, int _y[], unsigned int _size) {
+    x0 = _x0;
+    step = _step;
+    y = _y;
+    size = _size;
+    if ((step == 0) || (size == 0)) {
+        size = 0;
+        return false;
+    }
+    span = (unsigned long) (size-1)*step;
+    pow2 = ((step & (step-1)) == 0);
+    shift = 0;
+    if (pow2) {
+        while ((1U << shift) < step) {
+            shift++;
+        }
+    }
+    return true;
+}
+
+int UniformLookupTable::getValue(int x) {
+    // handle x values outside of range - return nearest end point value.
+    if (x <= x0) {
+        return y[0];
+    }
+    unsigned int dx = (unsigned int) x - (unsigned int) x0;
+    if (dx >= span) {
+        return y[size-1];
+    }
+
+    // x value is inside table - interpolate
+    unsigned int i;
+    unsigned int r;
+    if (pow2) {
+        i = dx >> shift;
+        r = dx & (step-1);
+    }
+    else {
+        i = dx/step;
+        r = dx - i*step;
+    }
+    long dy = ((long) y[i+1] - y[i])*r;
+    // Rounds towards zero like map()
+    if (pow2) {
+        dy = (dy < 0) ? -(-dy >> shift) : (dy >> shift);
+    }
+    else {
+        dy = dy/(long) step;
+    }
+    return y[i] + dy;
+}
@@ -0,0 +1,29 @@
+#ifndef UNIFORM_LOOKUP_TABLE_H
+#define UNIFORM_LOOKUP_TABLE_H
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// Lookup table with evenly spaced x values: point i is (x0 + i*step, y[i]).
+// The segment is found with one subtraction and a 16 bit division, and the
+// interpolation divides the 32 bit product by step. When step is a power of
+// two both divisions become shifts. getValue takes constant time and its
+// results are the same as LookupTable with the equivalent table.
+class UniformLookupTable {
+    public:
+        UniformLookupTable();
+        int getValue(int x);
+        bool setTable(int _x0, unsigned int _step, int _y[], unsigned int _size);
+    private:
+        int x0;
+        unsigned int step;
+        int *y;
+        unsigned int size;
+        unsigned long span;
+        bool pow2;
+        uint8_t shift;
+};
+
+#endif
@@ -0,0 +1,29 @@
+// Receives binary framed messages, e.g. sent from a PC with
+// host/sr_binary.py:
+//
+//   port.write(encode_frame([int16(3), float32(1.25)]))
+//
+#include "Streaming.h"
+#include "SerialReceiver.h"
+
+SerialReceiver receiver = SerialReceiver();
+
+void setup() {
+    Serial.begin(115200);
+    receiver.setMode(SR_MODE_BINARY);
+}
+
+void loop() {
+    int channel;
+    float setpoint;
+
+    while (Serial.available() > 0) {
+        receiver.process(Serial.read());
+        if (receiver.messageReady()) {
+            channel = receiver.readInt(0);
+            setpoint = receiver.readFloat(1);
+            Serial << "channel = " << _DEC(channel) << ", setpoint = " << setpoint << endl;
+            receiver.pop();
+        }
+    }
+}
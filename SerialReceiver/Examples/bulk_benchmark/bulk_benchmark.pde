@@ -0,0 +1,46 @@
+// Compares bytes/sec for feeding SerialReceiver one byte at a time with
+// process(int) and a block at a time with process(data, num).
+#include "Streaming.h"
+#include "SerialReceiver.h"
+
+#define NUM_PASSES 500
+
+const char message[] = "[setpoint,channel_a,12345,-678.25,enable]";
+
+SerialReceiver receiver = SerialReceiver();
+
+void setup() {
+    Serial.begin(115200);
+}
+
+void printResult(const char *name, unsigned long dt) {
+    float rate = (1.0e6*NUM_PASSES*(sizeof(message)-1))/dt;
+    Serial << name << ": " << rate << " bytes/sec" << endl;
+}
+
+void loop() {
+    unsigned long t0;
+    unsigned long dt;
+    size_t num = sizeof(message)-1;
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        for (size_t i=0; i<num; i++) {
+            receiver.process(message[i]);
+        }
+        receiver.reset();
+    }
+    dt = micros() - t0;
+    printResult("process(int)      ", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        receiver.process((const uint8_t *) message, num);
+        receiver.reset();
+    }
+    dt = micros() - t0;
+    printResult("process(data, num)", dt);
+
+    Serial << endl;
+    delay(2000);
+}
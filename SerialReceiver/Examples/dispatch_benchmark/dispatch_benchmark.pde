@@ -0,0 +1,99 @@
+// Compares the cost of finding the handler for a command among 64 commands
+// with a linear chain of string compares and with SerialDispatcher's binary
+// search of a sorted PROGMEM table.
+#include "Streaming.h"
+#include "SerialReceiver.h"
+#include "SerialDispatcher.h"
+
+#define NUM_COMMANDS 64
+#define NUM_PASSES 200
+
+volatile int handled;
+
+void handleCommand(SerialReceiverBase &receiver) {
+    handled++;
+}
+
+// Command names c00 ... c63, already in sorted order
+#define COMMAND_NAME(n) const char cmd##n[] PROGMEM = "c" #n;
+
+COMMAND_NAME(00) COMMAND_NAME(01) COMMAND_NAME(02) COMMAND_NAME(03) COMMAND_NAME(04) COMMAND_NAME(05) COMMAND_NAME(06) COMMAND_NAME(07)
+COMMAND_NAME(08) COMMAND_NAME(09) COMMAND_NAME(10) COMMAND_NAME(11) COMMAND_NAME(12) COMMAND_NAME(13) COMMAND_NAME(14) COMMAND_NAME(15)
+COMMAND_NAME(16) COMMAND_NAME(17) COMMAND_NAME(18) COMMAND_NAME(19) COMMAND_NAME(20) COMMAND_NAME(21) COMMAND_NAME(22) COMMAND_NAME(23)
+COMMAND_NAME(24) COMMAND_NAME(25) COMMAND_NAME(26) COMMAND_NAME(27) COMMAND_NAME(28) COMMAND_NAME(29) COMMAND_NAME(30) COMMAND_NAME(31)
+COMMAND_NAME(32) COMMAND_NAME(33) COMMAND_NAME(34) COMMAND_NAME(35) COMMAND_NAME(36) COMMAND_NAME(37) COMMAND_NAME(38) COMMAND_NAME(39)
+COMMAND_NAME(40) COMMAND_NAME(41) COMMAND_NAME(42) COMMAND_NAME(43) COMMAND_NAME(44) COMMAND_NAME(45) COMMAND_NAME(46) COMMAND_NAME(47)
+COMMAND_NAME(48) COMMAND_NAME(49) COMMAND_NAME(50) COMMAND_NAME(51) COMMAND_NAME(52) COMMAND_NAME(53) COMMAND_NAME(54) COMMAND_NAME(55)
+COMMAND_NAME(56) COMMAND_NAME(57) COMMAND_NAME(58) COMMAND_NAME(59) COMMAND_NAME(60) COMMAND_NAME(61) COMMAND_NAME(62) COMMAND_NAME(63)
+
+#define COMMAND(n) {cmd##n, handleCommand}
+const SR_Command commands[NUM_COMMANDS] PROGMEM = {
+    COMMAND(00), COMMAND(01), COMMAND(02), COMMAND(03), COMMAND(04), COMMAND(05), COMMAND(06), COMMAND(07),
+    COMMAND(08), COMMAND(09), COMMAND(10), COMMAND(11), COMMAND(12), COMMAND(13), COMMAND(14), COMMAND(15),
+    COMMAND(16), COMMAND(17), COMMAND(18), COMMAND(19), COMMAND(20), COMMAND(21), COMMAND(22), COMMAND(23),
+    COMMAND(24), COMMAND(25), COMMAND(26), COMMAND(27), COMMAND(28), COMMAND(29), COMMAND(30), COMMAND(31),
+    COMMAND(32), COMMAND(33), COMMAND(34), COMMAND(35), COMMAND(36), COMMAND(37), COMMAND(38), COMMAND(39),
+    COMMAND(40), COMMAND(41), COMMAND(42), COMMAND(43), COMMAND(44), COMMAND(45), COMMAND(46), COMMAND(47),
+    COMMAND(48), COMMAND(49), COMMAND(50), COMMAND(51), COMMAND(52), COMMAND(53), COMMAND(54), COMMAND(55),
+    COMMAND(56), COMMAND(57), COMMAND(58), COMMAND(59), COMMAND(60), COMMAND(61), COMMAND(62), COMMAND(63),
+};
+
+SerialReceiver receiver = SerialReceiver();
+SerialDispatcher dispatcher;
+
+void setup() {
+    Serial.begin(115200);
+    dispatcher.setTable(commands, NUM_COMMANDS);
+}
+
+void receive(const char *message) {
+    receiver.reset();
+    while (*message) {
+        receiver.process(*message);
+        message++;
+    }
+}
+
+// The usual hand written approach: compare item 0 with each name in turn
+void linearDispatch() {
+    char name[SR_MAX_ITEM_SZ+1];
+    SR_Command entry;
+    receiver.copyString(0, name, sizeof(name));
+    for (int i=0; i<NUM_COMMANDS; i++) {
+        memcpy_P(&entry, &commands[i], sizeof(SR_Command));
+        if (strcmp_P(name, entry.name) == 0) {
+            entry.handler(receiver);
+            return;
+        }
+    }
+}
+
+void printResult(const char *name, unsigned long dt) {
+    float cycles = (float) dt*(F_CPU/1000000UL)/NUM_PASSES;
+    Serial << name << ": " << cycles << " cycles per dispatch" << endl;
+}
+
+void loop() {
+    unsigned long t0;
+    unsigned long dt;
+
+    // Worst case for the linear search, the last command
+    receive("[c63,1,2]");
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        linearDispatch();
+    }
+    dt = micros() - t0;
+    printResult("linear    ", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        dispatcher.dispatch(receiver);
+    }
+    dt = micros() - t0;
+    printResult("dispatcher", dt);
+
+    Serial << endl;
+    delay(2000);
+}
@@ -0,0 +1,66 @@
+// Compares cycles per field for decoding a decimal number with atof, 
+// readDouble, readScaledInt and readFixed.
+#include "Streaming.h"
+#include "SerialReceiver.h"
+
+#define NUM_PASSES 1000
+#define FRAC_BITS 16
+#define DECIMALS 3
+
+const char message[] = "[-123.4567]";
+
+SerialReceiver receiver = SerialReceiver();
+volatile long sinkLong;
+volatile double sinkDouble;
+
+void setup() {
+    Serial.begin(115200);
+    for (size_t i=0; i<sizeof(message)-1; i++) {
+        receiver.process(message[i]);
+    }
+}
+
+void printResult(const char *name, unsigned long dt) {
+    float cycles = (float) dt*(F_CPU/1000000UL)/NUM_PASSES;
+    Serial << name << ": " << cycles << " cycles per field" << endl;
+}
+
+void loop() {
+    unsigned long t0;
+    unsigned long dt;
+    char str[SR_MAX_ITEM_SZ+1];
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        receiver.copyString(0, str, sizeof(str));
+        sinkDouble = atof(str);
+    }
+    dt = micros() - t0;
+    printResult("atof         ", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        sinkDouble = receiver.readDouble(0);
+    }
+    dt = micros() - t0;
+    printResult("readDouble   ", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        sinkLong = receiver.readScaledInt(0, DECIMALS);
+    }
+    dt = micros() - t0;
+    printResult("readScaledInt", dt);
+
+    t0 = micros();
+    for (int n=0; n<NUM_PASSES; n++) {
+        sinkLong = receiver.readFixed(0, FRAC_BITS);
+    }
+    dt = micros() - t0;
+    printResult("readFixed    ", dt);
+
+    Serial << "readScaledInt = " << receiver.readScaledInt(0, DECIMALS) << endl;
+    Serial << "readFixed     = " << sinkLong << endl;
+    Serial << endl;
+    delay(2000);
+}
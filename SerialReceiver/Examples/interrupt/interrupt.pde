@@ -0,0 +1,57 @@
+// Runs the receiver from an interrupt instead of polling Serial in loop().
+//
+// A timer interrupt stands in for the UART here and "receives" one byte of
+// a canned message every millisecond, so the example runs on an Uno with 
+// no second serial port. With a spare hardware UART the receive interrupt
+// feeds the receiver the same way, e.g. on a Mega:
+//
+//   ISR(USART1_RX_vect) {
+//       receiver.process(UDR1);
+//   }
+//
+// The callback runs inside the interrupt as soon as the stop character 
+// arrives and pulses LED_PIN, so command-to-action latency is set by the 
+// byte time rather than by how long loop() takes.
+#include "Streaming.h"
+#include "SerialReceiver.h"
+
+#define LED_PIN 13
+
+const char message[] = "[set,1,250]\n[set,2,-125]\n";
+
+SizedSerialReceiver<3,8,16,4> receiver;
+volatile uint8_t messagePos = 0;
+
+void onMessage(SerialReceiverBase &rx) {
+    digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+}
+
+ISR(TIMER2_COMPA_vect) {
+    receiver.process(message[messagePos]);
+    messagePos++;
+    if (messagePos == sizeof(message)-1) {
+        messagePos = 0;
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(LED_PIN, OUTPUT);
+    receiver.setCallback(onMessage);
+
+    // Timer2 compare interrupt at 1 kHz: 16 MHz / 64 / 250
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS22);
+    OCR2A = 249;
+    TIMSK2 = _BV(OCIE2A);
+}
+
+void loop() {
+    while (receiver.messageReady()) {
+        Serial << "channel = " << _DEC(receiver.readInt(1));
+        Serial << ", value = " << _DEC(receiver.readInt(2));
+        Serial << ", dropped = " << _DEC(receiver.getDroppedFrames()) << endl;
+        receiver.pop();
+    }
+    delay(100);
+}
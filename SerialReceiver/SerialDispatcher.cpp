@@ -0,0 +1,82 @@
+#include "SerialDispatcher.h"
+
+SerialDispatcher::SerialDispatcher() {
+    table = 0;
+    size = 0;
+}
+
+// Compares two NUL terminated strings in program memory like strcmp
+static int compareNames_P(const char *a, const char *b) {
+    uint8_t ca;
+    uint8_t cb;
+    do {
+        ca = pgm_read_byte(a++);
+        cb = pgm_read_byte(b++);
+    } while ((ca != 0) && (ca == cb));
+    return (int) ca - (int) cb;
+}
+
+// Sets the command table, returns false if the names are not in strictly
+// increasing order. Lookups would then fail so the table is not installed
+// and no command is found until a valid one is set.
+bool SerialDispatcher::setTable(const SR_Command *_table, uint8_t num) {
+    bool rtnVal = true;
+    SR_Command prev;
+    SR_Command cur;
+    table = _table;
+    size = num;
+    for (uint8_t i=1; i<size; i++) {
+        readEntry(i-1, prev);
+        readEntry(i, cur);
+        if (compareNames_P(prev.name, cur.name) >= 0) {
+            rtnVal = false;
+        }
+    }
+    if (!rtnVal) {
+        table = 0;
+        size = 0;
+    }
+    return rtnVal;
+}
+
+// Returns the table index of the command in item 0, or -1 if there is none
+int SerialDispatcher::find(SerialReceiverBase &receiver) {
+    int low = 0;
+    int high = size - 1;
+    SR_Command entry;
+    while (low <= high) {
+        int mid = (low + high) >> 1;
+        readEntry(mid, entry);
+        int cmp = receiver.compareItem_P(0, entry.name);
+        if (cmp == 0) {
+            return mid;
+        }
+        else if (cmp < 0) {
+            high = mid - 1;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+    return -1;
+}
+
+// Calls the handler for the current message, returns false if the command 
+// is unknown or no message is ready.
+bool SerialDispatcher::dispatch(SerialReceiverBase &receiver) {
+    if (!receiver.messageReady()) {
+        return false;
+    }
+    int index = find(receiver);
+    if (index < 0) {
+        return false;
+    }
+    SR_Command entry;
+    readEntry(index, entry);
+    entry.handler(receiver);
+    return true;
+}
+
+void SerialDispatcher::readEntry(uint8_t index, SR_Command &entry) {
+    memcpy_P(&entry, &table[index], sizeof(SR_Command));
+}
@@ -0,0 +1,40 @@
+#ifndef SerialDispatcher_h
+#define SerialDispatcher_h
+
+#include "SerialReceiver.h"
+
+typedef void (*SR_Handler)(SerialReceiverBase &receiver);
+
+// Command table entry, both the table and the names live in program memory:
+//
+//   const char cmdGet[] PROGMEM = "get";
+//   const char cmdSet[] PROGMEM = "set";
+//   const SR_Command commands[] PROGMEM = {
+//       {cmdGet, handleGet},
+//       {cmdSet, handleSet},
+//   };
+//
+// Entries must be sorted by name (strcmp order).
+struct SR_Command {
+    const char *name;
+    SR_Handler handler;
+};
+
+// Calls the handler registered for the command name in item 0 of the 
+// receiver's current message. Lookup is a binary search of the sorted table 
+// so dispatch cost grows with log2 of the number of commands.
+class SerialDispatcher {
+
+    public:
+        SerialDispatcher();
+        bool setTable(const SR_Command *table, uint8_t num);
+        int find(SerialReceiverBase &receiver);
+        bool dispatch(SerialReceiverBase &receiver);
+
+    private:
+        const SR_Command *table;
+        uint8_t size;
+        void readEntry(uint8_t index, SR_Command &entry);
+};
+
+#endif
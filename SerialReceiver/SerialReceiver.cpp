@@ -1,17 +1,197 @@
 #include "Streaming.h"
 #include "SerialReceiver.h"
+#include <limits.h>
 
-SerialReceiver::SerialReceiver() {
+// Parses a decimal integer in place from len characters at str, with the
+// same rules as atol: optional sign followed by digits, stops at the first
+// non digit.
+static long parseLong(const char *str, uint8_t len) {
+    uint8_t i = 0;
+    bool neg = false;
+    long value = 0;
+    if ((i < len) && ((str[i] == '-') || (str[i] == '+'))) {
+        neg = (str[i] == '-');
+        i++;
+    }
+    while ((i < len) && (str[i] >= '0') && (str[i] <= '9')) {
+        value = 10*value + (str[i] - '0');
+        i++;
+    }
+    return neg ? -value : value;
+}
+
+// Parses a decimal floating point number in place from len characters at
+// str, e.g. "-12.5" or "1.5e-3", stops at the first character that doesn't
+// fit the format.
+static double parseDouble(const char *str, uint8_t len) {
+    uint8_t i = 0;
+    bool neg = false;
+    double value = 0.0;
+    int exponent = 0;
+    if ((i < len) && ((str[i] == '-') || (str[i] == '+'))) {
+        neg = (str[i] == '-');
+        i++;
+    }
+    while ((i < len) && (str[i] >= '0') && (str[i] <= '9')) {
+        value = 10.0*value + (str[i] - '0');
+        i++;
+    }
+    if ((i < len) && (str[i] == '.')) {
+        i++;
+        while ((i < len) && (str[i] >= '0') && (str[i] <= '9')) {
+            value = 10.0*value + (str[i] - '0');
+            exponent--;
+            i++;
+        }
+    }
+    if ((i < len) && ((str[i] == 'e') || (str[i] == 'E'))) {
+        exponent += (int) parseLong(&str[i+1], len-i-1);
+    }
+    if (exponent != 0) {
+        value *= pow(10.0, exponent);
+    }
+    return neg ? -value : value;
+}
+
+// Splits a decimal number "[-]iii.fff" at str into its integer part, its 
+// fraction digits (at most 9 of them) and the number of fraction digits. 
+// An integer part too large for an unsigned long is returned as ULONG_MAX.
+// Returns true if the number is negative.
+static bool splitDecimal(const char *str, uint8_t len, unsigned long &intPart, 
+        unsigned long &fracPart, unsigned long &fracScale) {
+    uint8_t i = 0;
+    bool neg = false;
+    intPart = 0;
+    fracPart = 0;
+    fracScale = 1;
+    if ((i < len) && ((str[i] == '-') || (str[i] == '+'))) {
+        neg = (str[i] == '-');
+        i++;
+    }
+    while ((i < len) && (str[i] >= '0') && (str[i] <= '9')) {
+        if (intPart > (ULONG_MAX - 9)/10) {
+            intPart = ULONG_MAX;
+        }
+        else {
+            intPart = 10*intPart + (str[i] - '0');
+        }
+        i++;
+    }
+    if ((i < len) && (str[i] == '.')) {
+        i++;
+        while ((i < len) && (str[i] >= '0') && (str[i] <= '9') && (fracScale < 1000000000UL)) {
+            fracPart = 10*fracPart + (str[i] - '0');
+            fracScale *= 10;
+            i++;
+        }
+    }
+    return neg;
+}
+
+// Converts the bits of an IEEE single to fixed point with fracBits fraction
+// bits using integer math only, rounded to nearest with halves away from 
+// zero. Values out of the range of long saturate and NaN gives 0.
+static long floatBitsToFixed(uint32_t bits, uint8_t fracBits) {
+    bool neg = (bits & 0x80000000UL) != 0;
+    int exponent = (bits >> 23) & 0xFF;
+    unsigned long mantissa = bits & 0x7FFFFFUL;
+    unsigned long value;
+    if (exponent == 0xFF) {
+        if (mantissa != 0) {
+            return 0;
+        }
+        return neg ? -LONG_MAX : LONG_MAX;
+    }
+    if (exponent == 0) {
+        // Subnormal, no implicit leading one
+        exponent = 1;
+    }
+    else {
+        mantissa |= 0x800000UL;
+    }
+    // The float is mantissa*2^(exponent - 150), a 24 bit mantissa fits a
+    // long shifted left by up to 7
+    int shift = exponent - 150 + fracBits;
+    if (shift > 7) {
+        if (mantissa == 0) {
+            return 0;
+        }
+        return neg ? -LONG_MAX : LONG_MAX;
+    }
+    else if (shift >= 0) {
+        value = mantissa << shift;
+    }
+    else if (shift >= -25) {
+        value = ((mantissa >> (-shift - 1)) + 1) >> 1;
+    }
+    else {
+        value = 0;
+    }
+    return neg ? -(long) value : (long) value;
+}
+
+SerialReceiverBase::SerialReceiverBase(SR_Item *_items, char *_frame, uint8_t *_itemCounts, 
+        uint8_t _maxItems, uint8_t _maxItemSize, uint8_t _frameSize, uint8_t _depth) {
+    maxItems = _maxItems;
+    maxItemSize = _maxItemSize;
+    frameSize = _frameSize;
+    depth = _depth;
+    pushIndex = 0;
+    popIndex = 0;
+    callback = 0;
+    bindStorage(_items, _frame, _itemCounts);
+    clearStats();
     error = SR_ERR_NONE;
-    resetState();
     startChar = SR_DFLT_START_CHAR;
     stopChar = SR_DFLT_STOP_CHAR;
     sepChar = SR_DFLT_SEP_CHAR;
+    mode = SR_MODE_ASCII;
+    discarding = false;
+    clearSchema();
+    resetState();
+}
+
+void SerialReceiverBase::bindStorage(SR_Item *_items, char *_frame, uint8_t *_itemCounts) {
+    items = _items;
+    frameBuffer = _frame;
+    itemCounts = _itemCounts;
+    setReceiveSlot();
+}
+
+// Points the receive side at the first free slot of the queue
+void SerialReceiverBase::setReceiveSlot() {
+    uint8_t tail = tailSlot();
+    rxItems = items + tail*maxItems;
+    rxFrame = frameBuffer + tail*frameSize;
+}
+
+void SerialReceiverBase::setSchema(const uint8_t *types, uint8_t num) {
+    schema = types;
+    schemaLen = num;
     resetState();
 }
 
-bool SerialReceiver::messageReady() {
-    if (state == SR_STATE_MESSAGE) {
+void SerialReceiverBase::clearSchema() {
+    schema = 0;
+    schemaLen = 0;
+}
+
+void SerialReceiverBase::setMode(uint8_t _mode) {
+    mode = _mode;
+    reset();
+}
+
+uint8_t SerialReceiverBase::itemType(uint8_t itemNum) {
+    if ((mode == SR_MODE_ASCII) && (itemNum < schemaLen)) {
+        return schema[itemNum];
+    }
+    else {
+        return SR_TYPE_STRING;
+    }
+}
+
+bool SerialReceiverBase::messageReady() {
+    if (messageCount() > 0) {
         return true;
     }
     else {
@@ -19,20 +199,29 @@ bool SerialReceiver::messageReady() {
     }
 }
 
-uint8_t SerialReceiver::numberOfItems() {
-    if (state == SR_STATE_MESSAGE) {
-        return itemCnt;
+uint8_t SerialReceiverBase::numberOfItems() {
+    if (messageCount() > 0) {
+        return itemCounts[headSlot()];
+    }
+    else {
+        return 0;
+    }
+}
+
+uint8_t SerialReceiverBase::itemLength(uint8_t itemNum) {
+    if (checkItemRange(itemNum)) {
+        return msgItems()[itemNum].len;
     }
     else {
         return 0;
     }
 }
 
-char SerialReceiver::readChar(uint8_t itemNum, uint8_t ind) {
+char SerialReceiverBase::readChar(uint8_t itemNum, uint8_t ind) {
     char rval;
     if (checkItemRange(itemNum)) {
-        if (ind < itemLenBuffer[itemNum]) {
-            rval = itemBuffer[itemNum][ind];
+        if (ind < msgItems()[itemNum].len) {
+            rval = msgFrame()[msgItems()[itemNum].start + ind];
         }
         else {
             rval = 0;
@@ -44,51 +233,221 @@ char SerialReceiver::readChar(uint8_t itemNum, uint8_t ind) {
     return rval;
 }
 
-int SerialReceiver::readInt(uint8_t itemNum) {
+int SerialReceiverBase::readInt(uint8_t itemNum) {
+    return (int) readLong(itemNum);
+}
+
+long SerialReceiverBase::readLong(uint8_t itemNum) {
     if (checkItemRange(itemNum)) {
-        return atoi(itemBuffer[itemNum]);
+        if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) == SR_TYPE_FLOAT)) {
+            return (long) readBinaryFloat(itemNum);
+        }
+        if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) != SR_TYPE_STRING)) {
+            return readBinaryLong(itemNum);
+        }
+        if (itemType(itemNum) != SR_TYPE_STRING) {
+            long value = msgItems()[itemNum].value;
+            for (uint8_t i=0; i<msgItems()[itemNum].scale; i++) {
+                value /= 10;
+            }
+            return value;
+        }
+        return parseLong(&msgFrame()[msgItems()[itemNum].start], msgItems()[itemNum].len);
     }
     else {
         return 0;
     }
 }
 
-long SerialReceiver::readLong(uint8_t itemNum) {
-    if (checkItemRange(itemNum)) {
-        return atol(itemBuffer[itemNum]);
+double SerialReceiverBase::readDouble(uint8_t itemNum) {
+    if(checkItemRange(itemNum)) {
+        if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) == SR_TYPE_FLOAT)) {
+            return readBinaryFloat(itemNum);
+        }
+        if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) != SR_TYPE_STRING)) {
+            return readBinaryLong(itemNum);
+        }
+        if (itemType(itemNum) != SR_TYPE_STRING) {
+            double value = msgItems()[itemNum].value;
+            for (uint8_t i=0; i<msgItems()[itemNum].scale; i++) {
+                value /= 10.0;
+            }
+            return value;
+        }
+        return parseDouble(&msgFrame()[msgItems()[itemNum].start], msgItems()[itemNum].len);
     }
     else {
         return 0;
     }
 }
 
-double SerialReceiver::readDouble(uint8_t itemNum) {
-    if(checkItemRange(itemNum)) {
-        return atof(itemBuffer[itemNum]);
+// Returns the item as a fixed point number with fracBits fraction bits 
+// (e.g. fracBits = 8 gives Q23.8), rounded to nearest with halves away from
+// zero. The fraction is converted one bit at a time with shifts and 
+// compares, no float math or division is used, also not for binary float 
+// items. Values out of the range of long saturate to +-LONG_MAX.
+long SerialReceiverBase::readFixed(uint8_t itemNum, uint8_t fracBits) {
+    if (!checkItemRange(itemNum)) {
+        return 0;
     }
-    else {
+    if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) == SR_TYPE_FLOAT)) {
+        return floatBitsToFixed((uint32_t) readBinaryLong(itemNum), fracBits);
+    }
+    if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) != SR_TYPE_STRING)) {
+        long value = readBinaryLong(itemNum);
+        if (value > (LONG_MAX >> fracBits)) {
+            return LONG_MAX;
+        }
+        if (value < -(LONG_MAX >> fracBits)) {
+            return -LONG_MAX;
+        }
+        return value * (long) (1UL << fracBits);
+    }
+    unsigned long intPart;
+    unsigned long fracPart;
+    unsigned long fracScale;
+    bool neg = splitDecimal(&msgFrame()[msgItems()[itemNum].start], msgItems()[itemNum].len, 
+            intPart, fracPart, fracScale);
+    if (intPart > ((unsigned long) LONG_MAX >> fracBits)) {
+        return neg ? -LONG_MAX : LONG_MAX;
+    }
+    unsigned long value = intPart;
+    for (uint8_t i=0; i<fracBits; i++) {
+        fracPart <<= 1;
+        value <<= 1;
+        if (fracPart >= fracScale) {
+            fracPart -= fracScale;
+            value |= 1;
+        }
+    }
+    if (((fracPart << 1) >= fracScale) && (value < (unsigned long) LONG_MAX)) {
+        value++;
+    }
+    return neg ? -(long) value : (long) value;
+}
+
+// Returns the item times 10^decimals, rounded to nearest with halves away
+// from zero, e.g. "-1.235" with decimals = 2 gives -124. Only binary float 
+// items use float math. Values out of the range of long saturate to 
+// +-LONG_MAX.
+long SerialReceiverBase::readScaledInt(uint8_t itemNum, uint8_t decimals) {
+    if (!checkItemRange(itemNum)) {
         return 0;
     }
+    if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) == SR_TYPE_FLOAT)) {
+        double value = readBinaryFloat(itemNum);
+        for (uint8_t i=0; i<decimals; i++) {
+            value *= 10.0;
+        }
+        if (value >= (double) LONG_MAX) {
+            return LONG_MAX;
+        }
+        if (value <= (double) -LONG_MAX) {
+            return -LONG_MAX;
+        }
+        return (long) ((value < 0.0) ? value - 0.5 : value + 0.5);
+    }
+    if ((mode == SR_MODE_BINARY) && (binaryType(itemNum) != SR_TYPE_STRING)) {
+        long value = readBinaryLong(itemNum);
+        for (uint8_t i=0; i<decimals; i++) {
+            if (value > LONG_MAX/10) {
+                return LONG_MAX;
+            }
+            if (value < -LONG_MAX/10) {
+                return -LONG_MAX;
+            }
+            value *= 10;
+        }
+        return value;
+    }
+    const char *str = &msgFrame()[msgItems()[itemNum].start];
+    uint8_t len = msgItems()[itemNum].len;
+    uint8_t i = 0;
+    uint8_t digits = 0;
+    bool neg = false;
+    bool point = false;
+    unsigned long value = 0;
+    if ((i < len) && ((str[i] == '-') || (str[i] == '+'))) {
+        neg = (str[i] == '-');
+        i++;
+    }
+    for (; i < len; i++) {
+        if ((str[i] == '.') && !point) {
+            point = true;
+        }
+        else if ((str[i] >= '0') && (str[i] <= '9')) {
+            if (point && (digits == decimals)) {
+                // First dropped digit decides the rounding
+                if ((str[i] >= '5') && (value < (unsigned long) LONG_MAX)) {
+                    value++;
+                }
+                break;
+            }
+            if (value > (LONG_MAX - (str[i] - '0'))/10) {
+                return neg ? -LONG_MAX : LONG_MAX;
+            }
+            value = 10*value + (str[i] - '0');
+            if (point) {
+                digits++;
+            }
+        }
+        else {
+            break;
+        }
+    }
+    for (; digits < decimals; digits++) {
+        if (value > LONG_MAX/10) {
+            return neg ? -LONG_MAX : LONG_MAX;
+        }
+        value *= 10;
+    }
+    return neg ? -(long) value : (long) value;
 }
 
-float SerialReceiver::readFloat(uint8_t itemNum) {
+float SerialReceiverBase::readFloat(uint8_t itemNum) {
     return (float) readDouble(itemNum);
 }
 
-void SerialReceiver::copyString(uint8_t itemNum, char* string, uint8_t size) {
-    if (checkItemRange(itemNum)) {
-        strlcpy(string,itemBuffer[itemNum],size);
+void SerialReceiverBase::copyString(uint8_t itemNum, char* string, uint8_t size) {
+    uint8_t len = 0;
+    if (size == 0) {
+        return;
     }
-    else {
-        if (size >= 0) {
-            string[0] = '\0';
+    if (checkItemRange(itemNum)) {
+        len = msgItems()[itemNum].len;
+        if (len > size-1) {
+            len = size-1;
         }
+        memcpy(string, &msgFrame()[msgItems()[itemNum].start], len);
     }
+    string[len] = '\0';
 }
 
 
-bool SerialReceiver::checkItemRange(uint8_t itemNum) {
-    if ((state==SR_STATE_MESSAGE) && (itemNum >=0) && (itemNum < itemCnt)) {
+// Compares the item with a NUL terminated string in program memory, returns
+// <0, 0 or >0 like strcmp. A missing item compares as the empty string.
+int SerialReceiverBase::compareItem_P(uint8_t itemNum, const char *str) {
+    const char *item = 0;
+    uint8_t len = 0;
+    if (checkItemRange(itemNum)) {
+        item = &msgFrame()[msgItems()[itemNum].start];
+        len = msgItems()[itemNum].len;
+    }
+    for (uint8_t i=0; i<len; i++) {
+        uint8_t c = pgm_read_byte(str + i);
+        if (c == 0) {
+            // The string ended first, binary items may contain zero bytes
+            return 1;
+        }
+        if ((uint8_t) item[i] != c) {
+            return (int)(uint8_t) item[i] - (int) c;
+        }
+    }
+    return -(int) pgm_read_byte(str + len);
+}
+
+bool SerialReceiverBase::checkItemRange(uint8_t itemNum) {
+    if ((messageCount() > 0) && (itemNum >=0) && (itemNum < itemCounts[headSlot()])) {
         return true;
     }
     else {
@@ -96,8 +455,42 @@ bool SerialReceiver::checkItemRange(uint8_t itemNum) {
     }
 }
 
-void SerialReceiver::process(int serialByte) {
-    if (serialByte > 0){
+void SerialReceiverBase::process(int serialByte) {
+    if (messageCount() == depth) {
+        // No free slot, the byte is discarded
+        if (serialByte >= 0) {
+            stats.discardedBytes++;
+        }
+        if (mode == SR_MODE_BINARY) {
+            if (serialByte == 0) {
+                discarding = false;
+                resetBinaryFrame();
+            }
+            else if (serialByte > 0) {
+                // Count the frame once, its delimiter may only arrive after
+                // the queue has room again
+                if (!discarding) {
+                    stats.droppedFrames++;
+                    discarding = true;
+                }
+                state = SR_STATE_RESYNC;
+            }
+        }
+        else {
+            if (serialByte == startChar) {
+                stats.droppedFrames++;
+            }
+            // Skip the rest of the frame once there is room again
+            state = SR_STATE_RESYNC;
+        }
+        return;
+    }
+    if (mode == SR_MODE_BINARY) {
+        if (serialByte >= 0) {
+            processBinary(serialByte);
+        }
+    }
+    else if (serialByte > 0){
         switch (state) {
             case SR_STATE_IDLE:
                 processNewMsg(serialByte);
@@ -105,7 +498,8 @@ void SerialReceiver::process(int serialByte) {
             case SR_STATE_RECEIVING:
                 processCurMsg(serialByte);
                 break;
-            case SR_STATE_MESSAGE:
+            case SR_STATE_RESYNC:
+                processResync(serialByte);
                 break;
             default:
                 break;
@@ -114,9 +508,202 @@ void SerialReceiver::process(int serialByte) {
     }
 }
 
-void SerialReceiver::processNewMsg(int serialByte) {
+// Feeds a block of received bytes and returns how many were used. Stops 
+// right after the stop character of a complete message, so the remaining 
+// bytes can be passed in again once the message has been handled. Returns 0
+// while the message queue is full.
+size_t SerialReceiverBase::process(const uint8_t *data, size_t num) {
+    size_t i = 0;
+    uint8_t startIndex = pushIndex;
+    while ((i < num) && (pushIndex == startIndex) && (messageCount() < depth)) {
+        if ((mode == SR_MODE_ASCII) && (state == SR_STATE_RECEIVING) && (itemType(itemCnt) == SR_TYPE_STRING)) {
+            // Copy a run of plain item characters straight into the frame
+            uint8_t itemRoom = maxItemSize - itemPos;
+            uint8_t frameRoom = frameSize - framePos;
+            uint8_t room = (itemRoom < frameRoom) ? itemRoom : frameRoom;
+            while ((i < num) && (room > 0) && isItemChar(data[i])) {
+                rxFrame[framePos] = data[i];
+                framePos++;
+                itemPos++;
+                room--;
+                i++;
+            }
+            if (i == num) {
+                break;
+            }
+        }
+        process((int) data[i]);
+        i++;
+    }
+    return i;
+}
+
+bool SerialReceiverBase::isItemChar(uint8_t serialByte) {
+    return (serialByte != startChar) && (serialByte != stopChar) && (serialByte != sepChar) 
+        && (serialByte != '\n') && (serialByte != ' ') && (serialByte != 0);
+}
+
+// CRC-16/CCITT, polynomial 0x1021
+static uint16_t crc16Update(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t) data << 8;
+    for (uint8_t i=0; i<8; i++) {
+        if (crc & 0x8000) {
+            crc = (crc << 1) ^ 0x1021;
+        }
+        else {
+            crc <<= 1;
+        }
+    }
+    return crc;
+}
+
+// Binary mode: RECEIVING means COBS decoding a frame into the receive 
+// slot, any other state means out of sync and waiting for a 0x00 delimiter.
+void SerialReceiverBase::processBinary(int serialByte) {
+    if (state != SR_STATE_RECEIVING) {
+        if (serialByte == 0) {
+            discarding = false;
+            resetBinaryFrame();
+        }
+        else {
+            stats.discardedBytes++;
+        }
+        return;
+    }
+    if (serialByte == 0) {
+        endBinaryFrame();
+        return;
+    }
+    if (framePos == 0 && cobsRemaining == 0 && !cobsZeroPending) {
+        setReceiveSlot();
+    }
+    if (cobsRemaining == 0) {
+        // Code byte, the previous block ends with a zero unless it was a 
+        // full 254 byte block. The zero is held back because the last block
+        // of a frame has none.
+        if (cobsZeroPending) {
+            if (framePos == frameSize) {
+                abortFrame(SR_ERR_MESSAGE_LENGTH);
+                return;
+            }
+            rxFrame[framePos] = 0;
+            framePos++;
+        }
+        cobsRemaining = serialByte - 1;
+        cobsZeroPending = (serialByte != 0xFF);
+    }
+    else {
+        if (framePos == frameSize) {
+            abortFrame(SR_ERR_MESSAGE_LENGTH);
+            return;
+        }
+        rxFrame[framePos] = serialByte;
+        framePos++;
+        cobsRemaining--;
+    }
+}
+
+void SerialReceiverBase::resetBinaryFrame() {
+    resetItems();
+    cobsRemaining = 0;
+    cobsZeroPending = false;
+    state = SR_STATE_RECEIVING;
+}
+
+void SerialReceiverBase::endBinaryFrame() {
+    if ((framePos == 0) && !cobsZeroPending) {
+        // Back to back delimiters, nothing received
+        return;
+    }
+    if (cobsRemaining != 0) {
+        // Frame ended in the middle of a COBS block
+        setError(SR_ERR_ILLEGAL_CHAR);
+    }
+    else if (framePos < 2) {
+        setError(SR_ERR_CHECKSUM);
+    }
+    else {
+        uint16_t crc = 0xFFFF;
+        uint8_t payloadLen = framePos - 2;
+        for (uint8_t i=0; i<payloadLen; i++) {
+            crc = crc16Update(crc, rxFrame[i]);
+        }
+        uint16_t rxCrc = ((uint16_t)(uint8_t) rxFrame[payloadLen] << 8) | (uint8_t) rxFrame[payloadLen+1];
+        if (crc != rxCrc) {
+            setError(SR_ERR_CHECKSUM);
+        }
+        else {
+            framePos = payloadLen;
+            setError(splitBinaryFrame());
+        }
+    }
+    if (error == SR_ERR_NONE) {
+        pushMessage();
+    }
+    resetBinaryFrame();
+}
+
+// Walks the length prefixed items of a decoded frame and records them
+uint8_t SerialReceiverBase::splitBinaryFrame() {
+    uint8_t pos = 0;
+    itemCnt = 0;
+    while (pos < framePos) {
+        uint8_t type = (uint8_t) rxFrame[pos] >> SR_BIN_TYPE_SHIFT;
+        uint8_t len = rxFrame[pos] & SR_BIN_LEN_MASK;
+        pos++;
+        if ((len > maxItemSize) || (len > framePos - pos)) {
+            return SR_ERR_ITEM_LENGTH;
+        }
+        if (itemCnt == maxItems) {
+            return SR_ERR_MESSAGE_LENGTH;
+        }
+        if (((type == SR_TYPE_INT) || (type == SR_TYPE_LONG)) && (len != 1) && (len != 2) && (len != 4)) {
+            return SR_ERR_NUMBER_FORMAT;
+        }
+        if ((type == SR_TYPE_FLOAT) && (len != sizeof(float))) {
+            return SR_ERR_NUMBER_FORMAT;
+        }
+        rxItems[itemCnt].start = pos;
+        rxItems[itemCnt].len = len;
+        itemCnt++;
+        pos += len;
+    }
+    return SR_ERR_NONE;
+}
+
+// The item's header byte is kept in the frame just in front of its data
+uint8_t SerialReceiverBase::binaryType(uint8_t itemNum) {
+    return (uint8_t) msgFrame()[msgItems()[itemNum].start - 1] >> SR_BIN_TYPE_SHIFT;
+}
+
+// Reads a 4 byte little-endian IEEE float item (AVR and hosts are little-endian)
+float SerialReceiverBase::readBinaryFloat(uint8_t itemNum) {
+    float value;
+    memcpy(&value, &msgFrame()[msgItems()[itemNum].start], sizeof(float));
+    return value;
+}
+
+// Sign extends a 1 to 4 byte little-endian binary item
+long SerialReceiverBase::readBinaryLong(uint8_t itemNum) {
+    const uint8_t *data = (const uint8_t *) &msgFrame()[msgItems()[itemNum].start];
+    uint8_t len = msgItems()[itemNum].len;
+    if ((len == 0) || (len > 4)) {
+        return 0;
+    }
+    uint32_t value = 0;
+    for (uint8_t i=0; i<len; i++) {
+        value |= (uint32_t) data[i] << (8*i);
+    }
+    if ((len < 4) && (data[len-1] & 0x80)) {
+        value |= 0xFFFFFFFFUL << (8*len);
+    }
+    return (long)(int32_t) value;
+}
+
+void SerialReceiverBase::processNewMsg(int serialByte) {
     if (serialByte == startChar) {
         resetItems();
+        setReceiveSlot();
         state = SR_STATE_RECEIVING;
         error = SR_ERR_NONE;
     }
@@ -124,12 +711,22 @@ void SerialReceiver::processNewMsg(int serialByte) {
         return;
     }
     else {
-        error = SR_ERR_ILLEGAL_CHAR;
-        resetState();
+        abortFrame(SR_ERR_ILLEGAL_CHAR);
     }
 }
 
-void SerialReceiver::processCurMsg(int serialByte) {
+// After an error the rest of the frame is skipped up to the next start
+// character, the skipped bytes are counted as discarded, not as errors.
+void SerialReceiverBase::processResync(int serialByte) {
+    if (serialByte == startChar) {
+        processNewMsg(serialByte);
+    }
+    else {
+        stats.discardedBytes++;
+    }
+}
+
+void SerialReceiverBase::processCurMsg(int serialByte) {
     if (serialByte == startChar) {
         handleStartChar(serialByte);
     }
@@ -146,102 +743,309 @@ void SerialReceiver::processCurMsg(int serialByte) {
     }
 }
 
-void SerialReceiver::handleStartChar(int serialByte) {
-    resetState();
-    error = SR_ERR_ILLEGAL_CHAR;
+// A start character inside a frame drops the partial frame and starts a
+// new one.
+void SerialReceiverBase::handleStartChar(int serialByte) {
+    setError(SR_ERR_ILLEGAL_CHAR);
+    processNewMsg(serialByte);
+}
+
+bool SerialReceiverBase::endItem() {
+    uint8_t type = itemType(itemCnt);
+    if (type != SR_TYPE_STRING) {
+        if (!numDigit) {
+            return false;
+        }
+        // -INT_MIN overflows where long and int are both 32 bit
+        if ((type == SR_TYPE_INT) && (numNeg ? (numValue - 1 > INT_MAX) : (numValue > INT_MAX))) {
+            return false;
+        }
+        rxItems[itemCnt].value = numNeg ? -numValue : numValue;
+        rxItems[itemCnt].scale = numScale;
+        resetNumber();
+    }
+    rxItems[itemCnt].start = framePos - itemPos;
+    rxItems[itemCnt].len = itemPos;
+    itemCnt++;
+    itemPos = 0;
+    return true;
+}
+
+// Accumulates one character of a numeric item, returns false as soon as the
+// item can no longer be a valid number of its schema type.
+bool SerialReceiverBase::decodeNumberChar(int serialByte) {
+    uint8_t type = itemType(itemCnt);
+    if (type == SR_TYPE_STRING) {
+        return true;
+    }
+    if ((serialByte >= '0') && (serialByte <= '9')) {
+        uint8_t digit = serialByte - '0';
+        numDigit = true;
+        if (numValue > (LONG_MAX - digit)/10) {
+            // Extra fraction digits beyond the precision of a long are dropped
+            return numPoint;
+        }
+        numValue = 10*numValue + digit;
+        if (numPoint) {
+            numScale++;
+        }
+        return true;
+    }
+    if ((serialByte == '-') || (serialByte == '+')) {
+        numNeg = (serialByte == '-');
+        return (itemPos == 0);
+    }
+    if ((serialByte == '.') && (type == SR_TYPE_FLOAT) && !numPoint) {
+        numPoint = true;
+        return true;
+    }
+    return false;
 }
 
-void SerialReceiver::handleStopChar(int serialByte) {
+void SerialReceiverBase::resetNumber() {
+    numValue = 0;
+    numScale = 0;
+    numNeg = false;
+    numPoint = false;
+    numDigit = false;
+}
+
+void SerialReceiverBase::handleStopChar(int serialByte) {
     if (itemPos > 0) {
-        itemBuffer[itemCnt][itemPos] = '\0';
-        itemLenBuffer[itemCnt] = itemPos;
-        itemCnt++;
+        if (!endItem()) {
+            abortFrame(SR_ERR_NUMBER_FORMAT);
+            return;
+        }
     }
     // Check message checksum here .... if not OK reset.
-    state = SR_STATE_MESSAGE;
+    pushMessage();
+    resetState();
 }
 
-void SerialReceiver::handleSepChar(int serialByte) {
+void SerialReceiverBase::handleSepChar(int serialByte) {
     if (itemPos > 0) {
-        if (itemCnt == SR_MAX_ITEMS-1) {
-            resetState();
-            error = SR_ERR_MESSAGE_LENGTH;
+        if (itemCnt == maxItems-1) {
+            abortFrame(SR_ERR_MESSAGE_LENGTH);
         }
-        else {
-            itemBuffer[itemCnt][itemPos] = '\0';
-            itemLenBuffer[itemCnt] = itemPos;
-            itemCnt++;
-            itemPos = 0;
+        else if (!endItem()) {
+            abortFrame(SR_ERR_NUMBER_FORMAT);
         }
     }
     else {
-        resetState();
-        error = SR_ERR_ITEM_LENGTH;
+        abortFrame(SR_ERR_ITEM_LENGTH);
     }
 }
 
-void SerialReceiver::handleNewChar(int serialByte) {
-    if (itemPos == SR_MAX_ITEM_SZ) {
-        resetState();
-        error = SR_ERR_ITEM_LENGTH;
+void SerialReceiverBase::handleNewChar(int serialByte) {
+    if ((serialByte == '\n') || (serialByte == ' ')) {
+        return;
+    }
+    if (itemPos == maxItemSize) {
+        abortFrame(SR_ERR_ITEM_LENGTH);
+    }
+    else if (framePos == frameSize) {
+        abortFrame(SR_ERR_MESSAGE_LENGTH);
+    }
+    else if (!decodeNumberChar(serialByte)) {
+        abortFrame(SR_ERR_NUMBER_FORMAT);
     }
     else {
-        if ((serialByte == '\n') || (serialByte == ' ')) {
-            return;
-        }
-        itemBuffer[itemCnt][itemPos] = serialByte;
+        rxFrame[framePos] = serialByte;
+        framePos++;
         itemPos++;
     }
 }
 
-void SerialReceiver::reset() {
-    resetState();
+void SerialReceiverBase::reset() {
+    pushIndex = 0;
+    popIndex = 0;
+    discarding = false;
+    if (mode == SR_MODE_BINARY) {
+        resetBinaryFrame();
+    }
+    else {
+        resetState();
+    }
     error = SR_ERR_NONE;
 }
 
-void SerialReceiver::resetState() {
+// The queue is shared lock free between the context that calls process() 
+// (possibly an interrupt) and the one that reads messages. pushIndex is only
+// written by the former and popIndex by the latter. Both run over 0..2*depth-1
+// so that a full and an empty queue can be told apart, and as single bytes
+// they are read and written atomically on AVR.
+uint8_t SerialReceiverBase::nextIndex(uint8_t index) {
+    index++;
+    return (index == 2*depth) ? 0 : index;
+}
+
+uint8_t SerialReceiverBase::headSlot() {
+    uint8_t index = popIndex;
+    return (index < depth) ? index : index - depth;
+}
+
+uint8_t SerialReceiverBase::tailSlot() {
+    uint8_t index = pushIndex;
+    return (index < depth) ? index : index - depth;
+}
+
+void SerialReceiverBase::pushMessage() {
+    itemCounts[tailSlot()] = itemCnt;
+    // The message has to be complete in memory before it is published
+    SR_BARRIER();
+    pushIndex = nextIndex(pushIndex);
+    stats.framesOk++;
+    if (callback != 0) {
+        callback(*this);
+    }
+}
+
+void SerialReceiverBase::pop() {
+    if (messageCount() > 0) {
+        // Done reading the slot before it is handed back to the receiver
+        SR_BARRIER();
+        popIndex = nextIndex(popIndex);
+    }
+}
+
+uint8_t SerialReceiverBase::messageCount() {
+    uint8_t push = pushIndex;
+    uint8_t pop = popIndex;
+    SR_BARRIER();
+    return (push >= pop) ? push - pop : 2*depth - pop + push;
+}
+
+void SerialReceiverBase::setCallback(SR_Callback _callback) {
+    callback = _callback;
+}
+
+// Guarded like getStats, the counter is updated by process()
+unsigned long SerialReceiverBase::getDroppedFrames() {
+    unsigned long droppedFrames;
+#if defined(__AVR__)
+    uint8_t sreg = SREG;
+    cli();
+#endif
+    droppedFrames = stats.droppedFrames;
+#if defined(__AVR__)
+    SREG = sreg;
+#endif
+    return droppedFrames;
+}
+
+// Records a parse error of the frame being received
+void SerialReceiverBase::setError(uint8_t _error) {
+    error = _error;
+    switch (error) {
+        case SR_ERR_ILLEGAL_CHAR:
+            stats.illegalChar++;
+            break;
+        case SR_ERR_ITEM_LENGTH:
+            stats.itemLength++;
+            break;
+        case SR_ERR_MESSAGE_LENGTH:
+            stats.messageLength++;
+            break;
+        case SR_ERR_NUMBER_FORMAT:
+            stats.numberFormat++;
+            break;
+        case SR_ERR_CHECKSUM:
+            stats.checksum++;
+            break;
+        default:
+            break;
+    }
+}
+
+// The counters are updated by process(), which may run in an interrupt, so
+// on AVR the copy is made with interrupts disabled.
+void SerialReceiverBase::getStats(SR_Stats &_stats) {
+#if defined(__AVR__)
+    uint8_t sreg = SREG;
+    cli();
+#endif
+    _stats = stats;
+#if defined(__AVR__)
+    SREG = sreg;
+#endif
+}
+
+void SerialReceiverBase::clearStats() {
+#if defined(__AVR__)
+    uint8_t sreg = SREG;
+    cli();
+#endif
+    memset(&stats, 0, sizeof(stats));
+#if defined(__AVR__)
+    SREG = sreg;
+#endif
+}
+
+// Drops the frame being received after a parse error
+void SerialReceiverBase::abortFrame(uint8_t _error) {
+    resetItems();
+    state = SR_STATE_RESYNC;
+    setError(_error);
+}
+
+void SerialReceiverBase::resetState() {
     resetItems();
     state = SR_STATE_IDLE;
 }
 
-void SerialReceiver::resetItems() {
+void SerialReceiverBase::resetItems() {
     itemCnt = 0;
     itemPos = 0;
-    for (int i=0; i<SR_MAX_ITEMS;i++) {
-        itemBuffer[i][0] = '\0';
-        itemLenBuffer[i] = 0;
-    }
+    framePos = 0;
+    resetNumber();
 }
 
-void SerialReceiver::printInfo() {
+void SerialReceiverBase::printInfo() {
     Serial << "Current Message Info" << endl;
     Serial << "--------------------" << endl;
     Serial << "state:   " << _DEC(state) << endl;
     Serial << "error:   " << _DEC(error) << endl;
     Serial << "itemCnt: " << _DEC(itemCnt) << endl;
     Serial << "itemPos: " << _DEC(itemPos) << endl;
-    for (int i=0; i<itemCnt; i++) {
-        Serial << "buf[" << _DEC(i) << "] = " << itemBuffer[i] << endl;
+    Serial << "queued:  " << _DEC(messageCount()) << endl;
+    Serial << "dropped: " << _DEC(stats.droppedFrames) << endl;
+    for (int i=0; i<numberOfItems(); i++) {
+        Serial << "buf[" << _DEC(i) << "] = ";
+        printItem(i);
+        Serial << endl;
     }
     Serial << endl;
 }
 
-void SerialReceiver::printMessageInfo() {
+void SerialReceiverBase::printMessageInfo() {
     Serial << "Message = " << endl;
-    for (int i=0; i<itemCnt; i++) {
-        Serial << "buf[" << _DEC(i) << "] = " << itemBuffer[i] << ", len = " << _DEC(itemLenBuffer[i]) << endl;
+    for (int i=0; i<numberOfItems(); i++) {
+        Serial << "buf[" << _DEC(i) << "] = ";
+        printItem(i);
+        Serial << ", len = " << _DEC(msgItems()[i].len) << endl;
     }
     Serial << endl;
 }
 
-void SerialReceiver::printMessage() {
-    for (int i=0; i<itemCnt; i++) {
-        if (i < itemCnt-1) {
-            Serial << itemBuffer[i] << " ";
-        }
-        else {
-            Serial << itemBuffer[i];
+void SerialReceiverBase::printMessage() {
+    uint8_t num = numberOfItems();
+    for (int i=0; i<num; i++) {
+        printItem(i);
+        if (i < num-1) {
+            Serial << " ";
         }
     }
     Serial << endl;
 }
+
+SR_Item *SerialReceiverBase::msgItems() {
+    return items + headSlot()*maxItems;
+}
+
+char *SerialReceiverBase::msgFrame() {
+    return frameBuffer + headSlot()*frameSize;
+}
+
+void SerialReceiverBase::printItem(uint8_t itemNum) {
+    Serial.write((const uint8_t *) &msgFrame()[msgItems()[itemNum].start], msgItems()[itemNum].len);
+}
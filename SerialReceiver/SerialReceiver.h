@@ -9,6 +9,7 @@
 
 enum {SR_MAX_ITEM_SZ = 25};
 enum {SR_MAX_ITEMS = 5};
+enum {SR_MAX_FRAME_SZ = 64};    // SizedSerialReceiver default
 
 const char SR_DFLT_START_CHAR = '[';
 const char SR_DFLT_STOP_CHAR = ']';
@@ -17,19 +18,108 @@ const char SR_DFLT_SEP_CHAR = ',';
 const int SR_STATE_IDLE = 0;
 const int SR_STATE_RECEIVING = 1;
 const int SR_STATE_MESSAGE = 2;
+const int SR_STATE_RESYNC = 3;
 
 const int SR_ERR_NONE = 0;
 const int SR_ERR_ILLEGAL_CHAR = 1;
 const int SR_ERR_ITEM_LENGTH = 2;
 const int SR_ERR_MESSAGE_LENGTH = 3;
+const int SR_ERR_NUMBER_FORMAT = 4;
+const int SR_ERR_CHECKSUM = 5;
 
-class SerialReceiver {
+// Framing modes for setMode
+//
+// SR_MODE_ASCII: [item,item,...] text messages.
+// SR_MODE_BINARY: COBS encoded frames terminated by a 0x00 byte. The decoded 
+// frame is a sequence of items followed by a CRC-16/CCITT (poly 0x1021, 
+// init 0xFFFF) of the items, most significant byte first. Each item is a 
+// header byte, the item type (SR_TYPE_*) in the top two bits and the data 
+// length in the low six bits, followed by the data. SR_TYPE_INT and 
+// SR_TYPE_LONG items are 1, 2 or 4 byte little-endian signed integers, 
+// SR_TYPE_FLOAT items 4 byte little-endian IEEE floats, other lengths are
+// rejected with SR_ERR_NUMBER_FORMAT. SR_TYPE_STRING items are any bytes 
+// and are read as text, like in ASCII mode. Every read method converts 
+// from the item's type, e.g. readDouble of an int item is exact and 
+// readLong of a float item truncates. See host/sr_binary.py.
+const uint8_t SR_MODE_ASCII = 0;
+const uint8_t SR_MODE_BINARY = 1;
+
+// Item types for setSchema and the binary item header
+const uint8_t SR_TYPE_STRING = 0;
+const uint8_t SR_TYPE_INT = 1;
+const uint8_t SR_TYPE_LONG = 2;
+const uint8_t SR_TYPE_FLOAT = 3;
+
+const uint8_t SR_BIN_TYPE_SHIFT = 6;
+const uint8_t SR_BIN_LEN_MASK = 0x3F;
+
+// Orders the message data against the queue index updates when process() 
+// runs in an interrupt. On AVR a compiler barrier is enough, on hosts a full
+// fence is used.
+#if defined(__AVR__)
+#define SR_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define SR_BARRIER() __sync_synchronize()
+#endif
+
+// Per item bookkeeping, the item's characters are frame[start .. start+len-1]
+// and numeric schema items are decoded into value (scaled by 10^scale).
+struct SR_Item {
+    uint8_t start;
+    uint8_t len;
+    uint8_t scale;
+    long value;
+};
+
+// Cumulative receive counters, see getStats. Each parse error counts the 
+// frame it occurred in, which is then dropped. The rest of that frame, up 
+// to the next start character (0x00 in binary mode), is skipped and counted
+// in discardedBytes.
+struct SR_Stats {
+    unsigned long framesOk;         // messages queued
+    unsigned long illegalChar;      // SR_ERR_ILLEGAL_CHAR
+    unsigned long itemLength;       // SR_ERR_ITEM_LENGTH
+    unsigned long messageLength;    // SR_ERR_MESSAGE_LENGTH
+    unsigned long numberFormat;     // SR_ERR_NUMBER_FORMAT
+    unsigned long checksum;         // SR_ERR_CHECKSUM
+    unsigned long droppedFrames;    // frames lost because the queue was full
+    unsigned long discardedBytes;   // bytes skipped while the queue was full or after an error
+};
+
+// Receiver state machine working on caller provided storage for a queue of
+// depth messages: depth*maxItems SR_Item, depth*frameSize frame characters
+// and depth item counts. Use SerialReceiver, or SizedSerialReceiver for other
+// capacities, unless the storage has to be placed by hand.
+//
+// Completed messages are queued and the parser keeps accepting bytes while 
+// earlier messages wait. The read methods refer to the oldest message, pop()
+// discards it. Bytes arriving while the queue is full are discarded and 
+// counted as dropped frames. getStats reports these together with the parse
+// errors so link quality can be monitored without printing.
+//
+// process() may be called from an interrupt handler (e.g. the UART receive
+// interrupt) while loop() uses messageReady(), the read methods and pop(); 
+// no interrupts need to be disabled. Configuration, reset() and the print 
+// methods must not be used while the interrupt is feeding the receiver. The
+// optional callback runs in the context of process() each time a message is
+// queued.
+class SerialReceiverBase;
+typedef void (*SR_Callback)(SerialReceiverBase &receiver);
+
+class SerialReceiverBase {
 
     public:
-        SerialReceiver();
+        SerialReceiverBase(SR_Item *items, char *frame, uint8_t *itemCounts, 
+                uint8_t maxItems, uint8_t maxItemSize, uint8_t frameSize, uint8_t depth);
         void process(int serialByte);
+        size_t process(const uint8_t *data, size_t num);
         bool messageReady();
         void reset();
+        void pop();
+        uint8_t messageCount();
+        unsigned long getDroppedFrames();
+        void getStats(SR_Stats &stats);
+        void clearStats();
         uint8_t numberOfItems();
         uint8_t itemLength(uint8_t itemNum);
         char readChar(uint8_t itemNum, uint8_t ind); 
@@ -37,30 +127,137 @@ class SerialReceiver {
         long readLong(uint8_t itemNum);
         float readFloat(uint8_t itemNum);
         double readDouble(uint8_t itemNum);
+        long readFixed(uint8_t itemNum, uint8_t fracBits);
+        long readScaledInt(uint8_t itemNum, uint8_t decimals);
         void copyString(uint8_t itemNum, char *string, uint8_t size);
+        int compareItem_P(uint8_t itemNum, const char *str);
+        void setSchema(const uint8_t *types, uint8_t num);
+        void clearSchema();
+        void setMode(uint8_t mode);
+        void setCallback(SR_Callback callback);
         void printInfo();
         void printMessageInfo();
         void printMessage();
         
+    protected:
+        void bindStorage(SR_Item *items, char *frame, uint8_t *itemCounts);
+
     private:
         uint8_t state;
         uint8_t error;
-        char itemBuffer[SR_MAX_ITEMS][SR_MAX_ITEM_SZ+1];
-        uint8_t itemLenBuffer[SR_MAX_ITEMS];
+        // Item characters are stored back to back in frameBuffer (not NUL 
+        // terminated), item i starts at items[i].start.
+        char *frameBuffer;
+        SR_Item *items;
+        uint8_t *itemCounts;
+        uint8_t maxItems;
+        uint8_t maxItemSize;
+        uint8_t frameSize;
+        // Message queue, slot i uses items[i*maxItems] and frameBuffer[i*frameSize]
+        uint8_t depth;
+        volatile uint8_t pushIndex;
+        volatile uint8_t popIndex;
+        SR_Callback callback;
+        SR_Stats stats;
+        // Slot of the message being received
+        SR_Item *rxItems;
+        char *rxFrame;
         uint8_t itemCnt;
         uint8_t itemPos; 
+        uint8_t framePos;
+        // Optional item types, numeric items are decoded digit by digit as 
+        // they arrive.
+        const uint8_t *schema;
+        uint8_t schemaLen;
+        long numValue;
+        uint8_t numScale;
+        bool numNeg;
+        bool numPoint;
+        bool numDigit;
+        // Binary framing
+        uint8_t mode;
+        uint8_t cobsRemaining;
+        bool cobsZeroPending;
+        bool discarding;
         char startChar;
         char stopChar; 
         char sepChar;
+        void setError(uint8_t error);
+        void abortFrame(uint8_t error);
         void resetItems();
         void resetState();
         void processNewMsg(int serialByte);
         void processCurMsg(int serialByte);
+        void processResync(int serialByte);
         void handleNewChar(int serialByte);
         void handleSepChar(int serialByte);
         void handleStopChar(int serialByte);
         void handleStartChar(int serialByte);
         bool checkItemRange(uint8_t itemNum);
+        bool endItem();
+        uint8_t itemType(uint8_t itemNum);
+        bool decodeNumberChar(int serialByte);
+        void resetNumber();
+        bool isItemChar(uint8_t serialByte);
+        void printItem(uint8_t itemNum);
+        void setReceiveSlot();
+        uint8_t nextIndex(uint8_t index);
+        uint8_t headSlot();
+        uint8_t tailSlot();
+        void pushMessage();
+        void processBinary(int serialByte);
+        void resetBinaryFrame();
+        void endBinaryFrame();
+        uint8_t splitBinaryFrame();
+        uint8_t binaryType(uint8_t itemNum);
+        long readBinaryLong(uint8_t itemNum);
+        float readBinaryFloat(uint8_t itemNum);
+        SR_Item *msgItems();
+        char *msgFrame();
+};
+
+// Receiver with storage for MaxItems items of at most MaxItemSize characters
+// and MaxFrameSize characters in total per message, and a queue of Depth 
+// messages, so each command channel only pays for the memory it needs.
+// Depth can be at most 127.
+template<uint8_t MaxItems, uint8_t MaxItemSize, uint8_t MaxFrameSize = SR_MAX_FRAME_SZ, uint8_t Depth = 1>
+class SizedSerialReceiver : public SerialReceiverBase {
+
+    public:
+        SizedSerialReceiver() 
+            : SerialReceiverBase(itemArray, frameArray, countArray, MaxItems, MaxItemSize, MaxFrameSize, Depth) {}
+
+        SizedSerialReceiver(const SizedSerialReceiver &other) : SerialReceiverBase(other) {
+            copyStorage(other);
+        }
+
+        SizedSerialReceiver& operator=(const SizedSerialReceiver &other) {
+            SerialReceiverBase::operator=(other);
+            copyStorage(other);
+            return *this;
+        }
+
+    private:
+        SR_Item itemArray[Depth*MaxItems];
+        char frameArray[Depth*MaxFrameSize];
+        uint8_t countArray[Depth];
+
+        // The base class points at the storage so it has to be rebound to 
+        // this object's arrays after a copy.
+        void copyStorage(const SizedSerialReceiver &other) {
+            memcpy(itemArray, other.itemArray, sizeof(itemArray));
+            memcpy(frameArray, other.frameArray, sizeof(frameArray));
+            memcpy(countArray, other.countArray, sizeof(countArray));
+            bindStorage(itemArray, frameArray, countArray);
+        }
+};
+
+// Receiver with the default capacities SR_MAX_ITEMS and SR_MAX_ITEM_SZ. The
+// frame holds SR_MAX_ITEMS full size items, so any message that fits the 
+// item limits is accepted.
+class SerialReceiver : public SizedSerialReceiver<SR_MAX_ITEMS, SR_MAX_ITEM_SZ, SR_MAX_ITEMS*SR_MAX_ITEM_SZ> {
+    public:
+        SerialReceiver() {}
 };
 
 
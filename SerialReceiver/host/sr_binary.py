@@ -0,0 +1,249 @@
+"""
+sr_binary.py
+
+Host side encoder for the SerialReceiver binary framing mode (SR_MODE_BINARY).
+
+A frame is a sequence of items followed by the CRC-16/CCITT (poly 0x1021,
+init 0xFFFF) of the items sent most significant byte first. Each item is a
+header byte, holding the item type in the top two bits and the data length
+(at most 63) in the low six bits, followed by the data. The whole frame is
+COBS encoded and terminated by a 0x00 byte.
+
+The types match SerialReceiver's SR_TYPE_* constants: TYPE_STRING items are
+raw bytes (read as text on the Arduino, e.g. with readLong on b'12'),
+TYPE_INT and TYPE_LONG items are 1, 2 or 4 byte little-endian signed
+integers and TYPE_FLOAT items 4 byte little-endian IEEE floats. Since the
+type is sent with each item, readInt, readLong, readFloat and readDouble
+return the right value for any numeric item, e.g. readDouble of int32(7) is
+7.0.
+
+Usage:
+
+    import serial
+    from sr_binary import encode_frame, int16, int32, float32
+
+    port = serial.Serial('/dev/ttyACM0', 115200)
+    port.write(encode_frame([b'set', int16(3), float32(1.25)]))
+
+Running this file performs a randomized encode/decode round trip check of
+the framing. With --vectors FILE it instead writes test frames, some of
+them corrupted, for the host build's test_serial_receiver_binary:
+
+    python sr_binary.py --vectors binary_vectors.txt
+
+Author: IO Rodeo Inc.
+"""
+import struct
+import binascii
+import random
+import sys
+
+TYPE_STRING = 0
+TYPE_INT = 1
+TYPE_LONG = 2
+TYPE_FLOAT = 3
+
+MAX_ITEM_LENGTH = 63
+
+
+def int8(value):
+    return (TYPE_INT, struct.pack('<b', value))
+
+
+def int16(value):
+    return (TYPE_INT, struct.pack('<h', value))
+
+
+def int32(value):
+    return (TYPE_LONG, struct.pack('<i', value))
+
+
+def float32(value):
+    return (TYPE_FLOAT, struct.pack('<f', value))
+
+
+def item_value(item):
+    """
+    Returns the value of a (type, data) item as the Arduino reads it: an
+    int, a float or the data bytes of a string item.
+    """
+    item_type, data = item
+    if item_type == TYPE_FLOAT:
+        return struct.unpack('<f', data)[0]
+    if item_type in (TYPE_INT, TYPE_LONG):
+        return struct.unpack({1: '<b', 2: '<h', 4: '<i'}[len(data)], data)[0]
+    return data
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in bytearray(data):
+        crc ^= byte << 8
+        for i in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    """
+    Returns the COBS encoding of data, which contains no zero bytes. The
+    0x00 frame delimiter is not included.
+    """
+    out = bytearray()
+    block = bytearray()
+    for byte in bytearray(data):
+        if byte == 0:
+            out.append(len(block) + 1)
+            out.extend(block)
+            block = bytearray()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out.append(255)
+                out.extend(block)
+                block = bytearray()
+    out.append(len(block) + 1)
+    out.extend(block)
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    data = bytearray(data)
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data):
+            raise ValueError('bad COBS block')
+        out.extend(data[pos+1:pos+code])
+        pos += code
+        if code != 255 and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(items):
+    """
+    Encodes a list of items as a complete frame including the trailing 0x00
+    delimiter. An item is a byte string (a string item) or a (type, data)
+    tuple, see int8, int16, int32 and float32.
+    """
+    payload = bytearray()
+    for item in items:
+        if isinstance(item, tuple):
+            item_type, data = item
+        else:
+            item_type, data = TYPE_STRING, item
+        data = bytearray(data)
+        if len(data) > MAX_ITEM_LENGTH:
+            raise ValueError('item longer than {0} bytes'.format(MAX_ITEM_LENGTH))
+        if item_type in (TYPE_INT, TYPE_LONG) and len(data) not in (1, 2, 4):
+            raise ValueError('integer items are 1, 2 or 4 bytes')
+        if item_type == TYPE_FLOAT and len(data) != 4:
+            raise ValueError('float items are 4 bytes')
+        payload.append((item_type << 6) | len(data))
+        payload.extend(data)
+    crc = crc16(payload)
+    payload.append(crc >> 8)
+    payload.append(crc & 0xFF)
+    return cobs_encode(payload) + b'\x00'
+
+
+def decode_frame(frame):
+    """
+    Decodes a frame produced by encode_frame (with or without the delimiter)
+    back into a list of (type, data) items. Raises ValueError on a bad frame.
+    """
+    frame = bytearray(frame)
+    if frame and frame[-1] == 0:
+        frame = frame[:-1]
+    payload = bytearray(cobs_decode(frame))
+    if len(payload) < 2:
+        raise ValueError('frame too short')
+    crc = (payload[-2] << 8) | payload[-1]
+    payload = payload[:-2]
+    if crc16(payload) != crc:
+        raise ValueError('bad checksum')
+    items = []
+    pos = 0
+    while pos < len(payload):
+        item_type = payload[pos] >> 6
+        n = payload[pos] & MAX_ITEM_LENGTH
+        pos += 1
+        if pos + n > len(payload):
+            raise ValueError('bad item length')
+        items.append((item_type, bytes(payload[pos:pos+n])))
+        pos += n
+    return items
+
+
+def random_item():
+    item_type = random.choice([TYPE_STRING, TYPE_INT, TYPE_LONG, TYPE_FLOAT])
+    if item_type == TYPE_STRING:
+        n = random.choice([0, 1, 2, 4, random.randint(0, 12)])
+        return (item_type, bytes(bytearray(random.choice([0, random.randint(0, 255)]) for j in range(n))))
+    if item_type == TYPE_FLOAT:
+        value = random.choice([0.0, 1.25, -1.25, random.uniform(-1e6, 1e6), random.uniform(-2.0, 2.0)])
+        return float32(value)
+    n = random.choice([1, 2, 4])
+    value = random.randint(-2**(8*n-1), 2**(8*n-1) - 1)
+    return (item_type, struct.pack({1: '<b', 2: '<h', 4: '<i'}[n], value))
+
+
+def write_vectors(filename, count=3000):
+    """
+    Writes count test frames, one per line: a flag that is 1 for an intact
+    frame and 0 for a corrupted one, the frame bytes in hex and the items as
+    type:hex:value (hex and value are - when empty). Some frames have a bit
+    flipped, some are preceded by garbage.
+    """
+    random.seed(1)
+    with open(filename, 'w') as out:
+        for trial in range(count):
+            items = [random_item() for i in range(random.randint(0, 5))]
+            frame = bytearray(encode_frame(items))
+            ok = 1
+            if random.random() < 0.3:
+                k = random.randrange(len(frame) - 1)
+                frame[k] ^= 1 << random.randrange(8)
+                ok = 0
+            if random.random() < 0.1:
+                garbage = bytearray(random.randint(1, 255) for i in range(random.randint(0, 20)))
+                frame = garbage + bytearray([0]) + frame
+            fields = []
+            for item in items:
+                value = '-' if item[0] == TYPE_STRING else repr(item_value(item))
+                fields.append('{0}:{1}:{2}'.format(item[0], binascii.hexlify(item[1]).decode() or '-', value))
+            out.write('{0} {1} {2}\n'.format(ok, binascii.hexlify(frame).decode(), ' '.join(fields)).rstrip() + '\n')
+
+
+if __name__ == '__main__':
+
+    if len(sys.argv) > 2 and sys.argv[1] == '--vectors':
+        write_vectors(sys.argv[2])
+        sys.exit(0)
+
+    for trial in range(2000):
+        items = [random_item() for i in range(random.randint(0, 8))]
+        frame = encode_frame(items)
+        assert bytearray(frame).count(0) == 1
+        assert decode_frame(frame) == items
+
+        # Any single bit error must be rejected or change nothing
+        corrupt = bytearray(frame[:-1])
+        if corrupt:
+            k = random.randrange(len(corrupt))
+            corrupt[k] ^= 1 << random.randrange(8)
+            try:
+                assert decode_frame(bytes(corrupt)) != items or bytes(corrupt) == frame[:-1]
+            except ValueError:
+                pass
+
+    # Long blocks of non zero bytes
+    items = [bytes(bytearray(random.randint(1, 255) for j in range(63))) for i in range(5)]
+    assert decode_frame(encode_frame(items)) == [(TYPE_STRING, item) for item in items]
+
+    print('round trip ok')
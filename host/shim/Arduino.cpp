@@ -0,0 +1,276 @@
+/*
+  Arduino.cpp - host implementation of the Arduino core stand-in.
+ */
+
+#include "Arduino.h"
+#include "HostMock.h"
+#include <chrono>
+#include <deque>
+
+#define HOST_NUM_PINS 70
+
+HardwareSerial Serial;
+
+static uint8_t pinModes[HOST_NUM_PINS];
+static uint8_t pinLevels[HOST_NUM_PINS];
+static std::deque<uint8_t> serialInput;
+static std::string serialOutput;
+static FILE *serialEcho = 0;
+static std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+void hostSpiReset();
+void hostTwiReset();
+
+void hostReset()
+{
+	memset(pinModes, INPUT, sizeof(pinModes));
+	memset(pinLevels, LOW, sizeof(pinLevels));
+	serialInput.clear();
+	serialOutput.clear();
+	hostSpiReset();
+	hostTwiReset();
+}
+
+// Pins
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	if(pin < HOST_NUM_PINS)
+		pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	if(pin < HOST_NUM_PINS)
+		pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+	if(pin < HOST_NUM_PINS)
+		return pinLevels[pin];
+	return LOW;
+}
+
+void hostSetPin(uint8_t pin, int value)
+{
+	digitalWrite(pin, value);
+}
+
+int hostGetPinMode(uint8_t pin)
+{
+	if(pin < HOST_NUM_PINS)
+		return pinModes[pin];
+	return INPUT;
+}
+
+// Time, micros and millis follow the host clock, delays return immediately
+
+unsigned long micros()
+{
+	return (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long millis()
+{
+	return micros()/1000;
+}
+
+void delay(unsigned long ms)
+{
+	(void) ms;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	(void) us;
+}
+
+// Random numbers
+
+long random(long howbig)
+{
+	if(howbig == 0)
+		return 0;
+	return rand() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+	if(howsmall >= howbig)
+		return howsmall;
+	return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+	srand((unsigned int) seed);
+}
+
+// avr-libc conversions
+
+char *dtostre(double val, char *s, unsigned char prec, unsigned char flags)
+{
+	(void) flags;
+	sprintf(s, "%.*e", prec, val);
+	return s;
+}
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *s)
+{
+	sprintf(s, "%*.*f", width, prec, val);
+	return s;
+}
+
+// Print
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while(size--)
+		n += write(*buffer++);
+	return n;
+}
+
+size_t Print::write(const char *str)
+{
+	return write((const uint8_t *) str, strlen(str));
+}
+
+size_t Print::printNumber(unsigned long n, int base)
+{
+	char buf[8*sizeof(long) + 1];
+	char *str = &buf[sizeof(buf) - 1];
+	*str = '\0';
+	if(base < 2)
+		base = 10;
+	do {
+		unsigned long m = n;
+		n /= base;
+		char c = m - base*n;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while(n);
+	return write(str);
+}
+
+// Same output as the Arduino core, digits after the point without exponent
+size_t Print::printFloat(double number, int digits)
+{
+	char buf[64];
+	if(isnan(number))
+		return print("nan");
+	if(isinf(number))
+		return print("inf");
+	if(number > 4294967040.0 || number < -4294967040.0)
+		return print("ovf");
+	snprintf(buf, sizeof(buf), "%.*f", digits, number);
+	return write(buf);
+}
+
+size_t Print::print(const char *str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t) c); }
+size_t Print::print(unsigned char n, int base) { return print((unsigned long) n, base); }
+size_t Print::print(int n, int base) { return print((long) n, base); }
+size_t Print::print(unsigned int n, int base) { return print((unsigned long) n, base); }
+
+size_t Print::print(long n, int base)
+{
+	if(base == 0)
+		return write((uint8_t) n);
+	if(base == 10 && n < 0)
+		return print('-') + printNumber(-(unsigned long) n, 10);
+	return printNumber((unsigned long) n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	if(base == 0)
+		return write((uint8_t) n);
+	return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) { return printFloat(n, digits); }
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const char *str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char n, int base) { return print(n, base) + println(); }
+size_t Print::println(int n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned int n, int base) { return print(n, base) + println(); }
+size_t Print::println(long n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned long n, int base) { return print(n, base) + println(); }
+size_t Print::println(double n, int digits) { return print(n, digits) + println(); }
+
+// Serial port
+
+HardwareSerial::HardwareSerial()
+{
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+	(void) baud;
+}
+
+void HardwareSerial::end()
+{
+}
+
+int HardwareSerial::available()
+{
+	return (int) serialInput.size();
+}
+
+int HardwareSerial::read()
+{
+	if(serialInput.empty())
+		return -1;
+	int c = serialInput.front();
+	serialInput.pop_front();
+	return c;
+}
+
+int HardwareSerial::peek()
+{
+	if(serialInput.empty())
+		return -1;
+	return serialInput.front();
+}
+
+void HardwareSerial::flush()
+{
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	serialOutput += (char) c;
+	if(serialEcho)
+		fputc(c, serialEcho);
+	return 1;
+}
+
+void hostSerialInput(const uint8_t *data, size_t num)
+{
+	serialInput.insert(serialInput.end(), data, data + num);
+}
+
+void hostSerialInput(const char *str)
+{
+	hostSerialInput((const uint8_t *) str, strlen(str));
+}
+
+const std::string &hostSerialOutput()
+{
+	return serialOutput;
+}
+
+void hostSerialClearOutput()
+{
+	serialOutput.clear();
+}
+
+void hostSerialEcho(FILE *file)
+{
+	serialEcho = file;
+}
@@ -0,0 +1,137 @@
+/*
+  Arduino.h - minimal host stand-in for the Arduino core, used by the host
+  build (see CMakeLists.txt). Only what the libraries in this repository use
+  is provided. Pins, the serial port, SPI and TWI are mocks that tests can
+  inspect and drive through HostMock.h.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#ifndef ARDUINO
+#define ARDUINO 100
+#endif
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+char *dtostre(double val, char *s, unsigned char prec, unsigned char flags);
+char *dtostrf(double val, signed char width, unsigned char prec, char *s);
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size);
+	size_t write(const char *str);
+	// Keeps write(0x00) from being ambiguous with write(const char *)
+	size_t write(int c) { return write((uint8_t) c); }
+
+	size_t print(const char *str);
+	size_t print(char c);
+	size_t print(unsigned char n, int base = DEC);
+	size_t print(int n, int base = DEC);
+	size_t print(unsigned int n, int base = DEC);
+	size_t print(long n, int base = DEC);
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(double n, int digits = 2);
+
+	size_t println();
+	size_t println(const char *str);
+	size_t println(char c);
+	size_t println(unsigned char n, int base = DEC);
+	size_t println(int n, int base = DEC);
+	size_t println(unsigned int n, int base = DEC);
+	size_t println(long n, int base = DEC);
+	size_t println(unsigned long n, int base = DEC);
+	size_t println(double n, int digits = 2);
+
+private:
+	size_t printNumber(unsigned long n, int base);
+	size_t printFloat(double n, int digits);
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+};
+
+// Serial port mock: written bytes are collected in output (and echoed to
+// echo if set), bytes queued with hostSerialInput are returned by read().
+class HardwareSerial : public Stream
+{
+public:
+	HardwareSerial();
+	void begin(unsigned long baud);
+	void end();
+	int available();
+	int read();
+	int peek();
+	void flush();
+	using Print::write;
+	size_t write(uint8_t c);
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
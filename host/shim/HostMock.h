@@ -0,0 +1,42 @@
+/*
+  HostMock.h - controls the mocked hardware of the host build: pin levels,
+  the serial port, the SPI bus and devices on the TWI (I2C) bus.
+ */
+
+#ifndef HOST_MOCK_H
+#define HOST_MOCK_H
+
+#include "Arduino.h"
+#include <string>
+#include <vector>
+
+// Restores all mocks to their power on state
+void hostReset();
+
+// Pins, digitalRead returns the level set here for inputs and the last
+// written level for outputs
+void hostSetPin(uint8_t pin, int value);
+int hostGetPinMode(uint8_t pin);
+
+// Serial port
+void hostSerialInput(const uint8_t *data, size_t num);
+void hostSerialInput(const char *str);
+const std::string &hostSerialOutput();
+void hostSerialClearOutput();
+// Also copy everything written to Serial to file (e.g. stdout), 0 to stop
+void hostSerialEcho(FILE *file);
+
+// SPI bus, every byte sent is logged and the responder (if any) supplies
+// the byte received in the same transfer, 0 otherwise
+typedef uint8_t (*HostSpiResponder)(uint8_t out);
+void hostSpiSetResponder(HostSpiResponder responder);
+const std::vector<uint8_t> &hostSpiLog();
+void hostSpiClearLog();
+bool hostSpiInTransaction();
+
+// TWI bus, a device is a 256 byte register file with an auto incrementing
+// register pointer: a write sets the pointer with its first byte and stores
+// the rest, a read returns registers starting at the pointer
+void hostTwiAddDevice(uint8_t address, uint8_t *registers);
+
+#endif
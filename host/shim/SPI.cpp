@@ -0,0 +1,81 @@
+/*
+  SPI.cpp - host mock of the SPI bus.
+ */
+
+#include "SPI.h"
+#include "HostMock.h"
+
+SPIClass SPI;
+
+static HostSpiResponder responder = 0;
+static std::vector<uint8_t> spiLog;
+static bool inTransaction = false;
+
+void hostSpiReset()
+{
+	responder = 0;
+	spiLog.clear();
+	inTransaction = false;
+}
+
+void hostSpiSetResponder(HostSpiResponder _responder)
+{
+	responder = _responder;
+}
+
+const std::vector<uint8_t> &hostSpiLog()
+{
+	return spiLog;
+}
+
+void hostSpiClearLog()
+{
+	spiLog.clear();
+}
+
+bool hostSpiInTransaction()
+{
+	return inTransaction;
+}
+
+void SPIClass::begin()
+{
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	(void) settings;
+	inTransaction = true;
+}
+
+void SPIClass::endTransaction()
+{
+	inTransaction = false;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	spiLog.push_back(data);
+	if(responder)
+		return responder(data);
+	return 0;
+}
+
+void SPIClass::setBitOrder(uint8_t bitOrder)
+{
+	(void) bitOrder;
+}
+
+void SPIClass::setDataMode(uint8_t dataMode)
+{
+	(void) dataMode;
+}
+
+void SPIClass::setClockDivider(uint8_t clockDiv)
+{
+	(void) clockDiv;
+}
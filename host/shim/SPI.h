@@ -0,0 +1,50 @@
+/*
+  SPI.h - host stand-in for the Arduino SPI library. Transfers go to a mock
+  bus that records the bytes sent and answers through a responder function,
+  see HostMock.h.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV32 0x06
+
+class SPISettings
+{
+public:
+	SPISettings(): clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+	SPISettings(uint32_t c, uint8_t b, uint8_t d): clock(c), bitOrder(b), dataMode(d) {}
+	uint32_t clock;
+	uint8_t bitOrder;
+	uint8_t dataMode;
+};
+
+class SPIClass
+{
+public:
+	void begin();
+	void end();
+	void beginTransaction(SPISettings settings);
+	void endTransaction();
+	uint8_t transfer(uint8_t data);
+	void setBitOrder(uint8_t bitOrder);
+	void setDataMode(uint8_t dataMode);
+	void setClockDivider(uint8_t clockDiv);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,26 @@
+/*
+  SoftwareSerial.h - host stand-in, a Stream that behaves like the Serial
+  mock (written bytes are collected in output, see HostMock.h).
+ */
+
+#ifndef HOST_SOFTWARE_SERIAL_H
+#define HOST_SOFTWARE_SERIAL_H
+
+#include "Arduino.h"
+#include <string>
+
+class SoftwareSerial : public Stream
+{
+public:
+	SoftwareSerial(uint8_t rxPin, uint8_t txPin) { (void) rxPin; (void) txPin; }
+	void begin(long baud) { (void) baud; }
+	int available() { return 0; }
+	int read() { return -1; }
+	int peek() { return -1; }
+	using Print::write;
+	size_t write(uint8_t c) { output += (char) c; return 1; }
+
+	std::string output;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+  Streaming.h - host stand-in for Mikal Hart's Streaming library, provides
+  the << operator for Print objects and the _DEC/_HEX/_OCT/_BIN helpers.
+ */
+
+#ifndef HOST_STREAMING_H
+#define HOST_STREAMING_H
+
+#include "Arduino.h"
+
+template<class T>
+inline Print &operator <<(Print &obj, T arg)
+{
+	obj.print(arg);
+	return obj;
+}
+
+struct _BASED
+{
+	long val;
+	int base;
+	_BASED(long v, int b): val(v), base(b) {}
+};
+
+#define _HEX(a) _BASED(a, HEX)
+#define _DEC(a) _BASED(a, DEC)
+#define _OCT(a) _BASED(a, OCT)
+#define _BIN(a) _BASED(a, BIN)
+
+inline Print &operator <<(Print &obj, const _BASED &arg)
+{
+	obj.print(arg.val, arg.base);
+	return obj;
+}
+
+enum _EndLineCode { endl };
+
+inline Print &operator <<(Print &obj, _EndLineCode)
+{
+	obj.println();
+	return obj;
+}
+
+#endif
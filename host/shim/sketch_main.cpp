@@ -0,0 +1,21 @@
+/*
+  sketch_main.cpp - runs an example sketch on the host: setup() once, then
+  loop() the number of times given on the command line (default 1), with
+  Serial output going to stdout.
+ */
+
+#include "HostMock.h"
+
+void setup();
+void loop();
+
+int main(int argc, char **argv)
+{
+	int passes = (argc > 1) ? atoi(argv[1]) : 1;
+	hostReset();
+	hostSerialEcho(stdout);
+	setup();
+	for(int i = 0; i < passes; i++)
+		loop();
+	return 0;
+}
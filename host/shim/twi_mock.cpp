@@ -0,0 +1,117 @@
+/*
+  twi_mock.cpp - host mock of the TWI (I2C) bus, replaces FastWire's
+  utility/fast_twi.c which drives the AVR TWI registers. Only master mode is
+  modelled.
+ */
+
+#include "HostMock.h"
+extern "C" {
+#include "utility/fast_twi.h"
+}
+
+#define HOST_TWI_MAX_DEVICES 8
+
+struct HostTwiDevice
+{
+	uint8_t address;
+	uint8_t *registers;
+	uint8_t pointer;
+};
+
+static HostTwiDevice devices[HOST_TWI_MAX_DEVICES];
+static uint8_t numDevices = 0;
+
+void hostTwiReset()
+{
+	numDevices = 0;
+}
+
+void hostTwiAddDevice(uint8_t address, uint8_t *registers)
+{
+	if(numDevices == HOST_TWI_MAX_DEVICES)
+		return;
+	devices[numDevices].address = address;
+	devices[numDevices].registers = registers;
+	devices[numDevices].pointer = 0;
+	numDevices++;
+}
+
+static HostTwiDevice *findDevice(uint8_t address)
+{
+	for(uint8_t i = 0; i < numDevices; i++){
+		if(devices[i].address == address)
+			return &devices[i];
+	}
+	return 0;
+}
+
+extern "C" {
+
+void twi_init(void)
+{
+}
+
+void twi_setAddress(uint8_t address)
+{
+	(void) address;
+}
+
+// Returns the number of bytes read, 0 if no device answers
+uint8_t twi_readFrom(uint8_t address, uint8_t *data, uint8_t length)
+{
+	HostTwiDevice *device = findDevice(address);
+	if(device == 0 || length > TWI_BUFFER_LENGTH)
+		return 0;
+	for(uint8_t i = 0; i < length; i++)
+		data[i] = device->registers[device->pointer++];
+	return length;
+}
+
+// Returns 0 on success, 1 if the data is too long and 2 if no device
+// acknowledges the address, as the AVR implementation does
+uint8_t twi_writeTo(uint8_t address, uint8_t *data, uint8_t length, uint8_t wait)
+{
+	(void) wait;
+	if(length > TWI_BUFFER_LENGTH)
+		return 1;
+	HostTwiDevice *device = findDevice(address);
+	if(device == 0)
+		return 2;
+	if(length > 0)
+		device->pointer = data[0];
+	for(uint8_t i = 1; i < length; i++)
+		device->registers[device->pointer++] = data[i];
+	return 0;
+}
+
+uint8_t twi_transmit(uint8_t *data, uint8_t length)
+{
+	(void) data;
+	(void) length;
+	return 1;
+}
+
+void twi_attachSlaveRxEvent(void (*function)(uint8_t *, int))
+{
+	(void) function;
+}
+
+void twi_attachSlaveTxEvent(void (*function)(void))
+{
+	(void) function;
+}
+
+void twi_reply(uint8_t ack)
+{
+	(void) ack;
+}
+
+void twi_stop(void)
+{
+}
+
+void twi_releaseBus(void)
+{
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+  HostTest.cpp - runs every TEST case of the executable, see HostTest.h.
+  An optional command line argument only runs the case with that name.
+ */
+
+#include "HostTest.h"
+#include <string.h>
+
+static HostTestCase *firstCase = 0;
+static HostTestCase *lastCase = 0;
+static int failedChecks = 0;
+
+HostTestCase::HostTestCase(const char *_name, HostTestFunction _function)
+{
+	name = _name;
+	function = _function;
+	next = 0;
+	if(lastCase)
+		lastCase->next = this;
+	else
+		firstCase = this;
+	lastCase = this;
+}
+
+bool hostCheck(bool ok, const char *expr, const char *file, int line)
+{
+	if(!ok){
+		std::cerr << file << ":" << line << ": check failed: " << expr << std::endl;
+		failedChecks++;
+	}
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	int numCases = 0;
+	int failedCases = 0;
+	for(HostTestCase *c = firstCase; c; c = c->next){
+		if(argc > 1 && strcmp(argv[1], c->name) != 0)
+			continue;
+		int before = failedChecks;
+		hostReset();
+		c->function();
+		numCases++;
+		if(failedChecks != before){
+			failedCases++;
+			std::cerr << "FAILED " << c->name << std::endl;
+		}
+	}
+	std::cout << numCases - failedCases << " of " << numCases << " test cases passed" << std::endl;
+	return (failedCases == 0 && numCases > 0) ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+/*
+  HostTest.h - minimal test runner for the host build. Each test_*.cpp file
+  defines TEST cases and is linked with HostTest.cpp into one executable,
+  which runs all of them and fails if any check fails.
+
+  TEST(putAndGet) {
+      CHECK(buffer.put(1) == 1);
+      CHECK_EQUAL(buffer.get(), 1);
+  }
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include "HostMock.h"
+#include <iostream>
+
+typedef void (*HostTestFunction)();
+
+struct HostTestCase
+{
+	HostTestCase(const char *name, HostTestFunction function);
+	const char *name;
+	HostTestFunction function;
+	HostTestCase *next;
+};
+
+bool hostCheck(bool ok, const char *expr, const char *file, int line);
+
+#define TEST(name) \
+	static void name(); \
+	static HostTestCase name##_case(#name, name); \
+	static void name()
+
+#define CHECK(expr) hostCheck((expr) ? true : false, #expr, __FILE__, __LINE__)
+
+// Prints both values when they differ
+#define CHECK_EQUAL(actual, expected) \
+	do { \
+		if(!hostCheck((actual) == (expected), #actual " == " #expected, __FILE__, __LINE__)) \
+			std::cerr << "    actual: " << (actual) << ", expected: " << (expected) << std::endl; \
+	} while(0)
+
+#endif
@@ -0,0 +1,289 @@
+// Host tests for ByteBuffer, FixedByteBuffer and RecordRing
+#include "HostTest.h"
+#include "ByteBuffer.h"
+#include "FixedByteBuffer.h"
+#include "RecordRing.h"
+
+// Moves the start of the stored data to offset so that the tests wrap
+static void startAt(ByteBuffer &buffer, int offset) {
+    buffer.clear();
+    for (int i=0; i<offset; i++) {
+        buffer.put(0);
+        buffer.get();
+    }
+}
+
+TEST(putAndGet) {
+    ByteBuffer buffer;
+    CHECK(buffer.init(4));
+    CHECK_EQUAL(buffer.getCapacity(), 4);
+    for (int i=0; i<4; i++) {
+        CHECK_EQUAL(buffer.put(i+1), 1);
+    }
+    CHECK_EQUAL(buffer.put(5), 0);
+    CHECK_EQUAL(buffer.getSize(), 4);
+    CHECK_EQUAL(buffer.peek(3), 4);
+    for (int i=0; i<4; i++) {
+        CHECK_EQUAL(buffer.get(), i+1);
+    }
+    CHECK_EQUAL(buffer.getSize(), 0);
+    buffer.deAllocate();
+}
+
+TEST(callerStorage) {
+    byte storage[3];
+    ByteBuffer buffer(storage, sizeof(storage));
+    CHECK_EQUAL(buffer.getCapacity(), 3);
+    buffer.put(7);
+    CHECK_EQUAL(storage[0], 7);
+    CHECK(!buffer.init(0, 3));
+    CHECK_EQUAL(buffer.getCapacity(), 0);
+    CHECK_EQUAL(buffer.put(1), 0);
+}
+
+// Every multi-byte value is written and read at every wrap position
+TEST(explicitByteOrder) {
+    ByteBuffer buffer;
+    buffer.init(11);
+    for (int start=0; start<11; start++) {
+        startAt(buffer, start);
+        CHECK(buffer.putUInt16LE(0x1234));
+        CHECK_EQUAL(buffer.peek(0), 0x34);
+        CHECK_EQUAL(buffer.getUInt16LE(), 0x1234);
+
+        startAt(buffer, start);
+        CHECK(buffer.putUInt16BE(0x1234));
+        CHECK_EQUAL(buffer.peek(0), 0x12);
+        CHECK_EQUAL(buffer.getUInt16BE(), 0x1234);
+
+        startAt(buffer, start);
+        CHECK(buffer.putUInt32LE(0x12345678));
+        CHECK_EQUAL(buffer.peek(0), 0x78);
+        CHECK_EQUAL(buffer.getUInt32LE(), 0x12345678u);
+
+        startAt(buffer, start);
+        CHECK(buffer.putUInt32BE(0x12345678));
+        CHECK_EQUAL(buffer.peek(3), 0x78);
+        CHECK_EQUAL(buffer.getUInt32BE(), 0x12345678u);
+
+        startAt(buffer, start);
+        CHECK(buffer.putFloatLE(3.25f));
+        CHECK(buffer.putFloatBE(-3.25f));
+        CHECK_EQUAL(buffer.getFloatLE(), 3.25f);
+        CHECK_EQUAL(buffer.getFloatBE(), -3.25f);
+
+        // Too few bytes, nothing is removed
+        startAt(buffer, start);
+        buffer.put(1);
+        CHECK_EQUAL(buffer.getUInt16LE(), 0);
+        CHECK_EQUAL(buffer.getUInt32BE(), 0u);
+        CHECK_EQUAL(buffer.getSize(), 1);
+    }
+    buffer.deAllocate();
+}
+
+TEST(nativeValues) {
+    ByteBuffer buffer;
+    buffer.init(11);
+    for (int start=0; start<11; start++) {
+        startAt(buffer, start);
+        CHECK(buffer.putInt(-1234));
+        CHECK(buffer.putLong(-123456789L));
+        CHECK(buffer.putFloat(1.5f));
+        CHECK(!buffer.putInt(1));
+        CHECK_EQUAL(buffer.getSize(), 10);
+        CHECK_EQUAL(buffer.getInt(), -1234);
+        CHECK_EQUAL(buffer.getLong(), -123456789L);
+        CHECK_EQUAL(buffer.getFloat(), 1.5f);
+        CHECK_EQUAL(buffer.getSize(), 0);
+        CHECK_EQUAL(buffer.getInt(), 0);
+
+        startAt(buffer, start);
+        buffer.put(9);
+        CHECK(buffer.putIntInFront(-7));
+        CHECK(buffer.putLongInFront(70000));
+        CHECK(buffer.putFloatInFront(2.5f));
+        CHECK_EQUAL(buffer.getFloat(), 2.5f);
+        CHECK_EQUAL(buffer.getLong(), 70000);
+        CHECK_EQUAL(buffer.getInt(), -7);
+        CHECK_EQUAL(buffer.get(), 9);
+
+        startAt(buffer, start);
+        buffer.putInt(5);
+        buffer.putLong(-6);
+        buffer.putFloat(7.5f);
+        CHECK_EQUAL(buffer.getFloatFromBack(), 7.5f);
+        CHECK_EQUAL(buffer.getLongFromBack(), -6);
+        CHECK_EQUAL(buffer.getIntFromBack(), 5);
+    }
+    buffer.deAllocate();
+}
+
+TEST(bulkWriteRead) {
+    ByteBuffer buffer;
+    buffer.init(10);
+    for (int start=0; start<10; start++) {
+        byte in[12];
+        byte out[12];
+        startAt(buffer, start);
+        for (int i=0; i<12; i++) {
+            in[i] = i+1;
+        }
+        CHECK_EQUAL(buffer.write(in, 7), 7u);
+        CHECK_EQUAL(buffer.write(in+7, 5), 3u);
+        CHECK_EQUAL(buffer.getSize(), 10);
+        CHECK_EQUAL(buffer.peek(out, 2, 20), 8u);
+        for (int i=0; i<8; i++) {
+            CHECK_EQUAL(out[i], i+3);
+        }
+        CHECK_EQUAL(buffer.read(out, 4), 4u);
+        for (int i=0; i<4; i++) {
+            CHECK_EQUAL(out[i], i+1);
+        }
+        CHECK_EQUAL(buffer.get(), 5);
+        CHECK_EQUAL(buffer.read(out, 20), 5u);
+        for (int i=0; i<5; i++) {
+            CHECK_EQUAL(out[i], i+6);
+        }
+    }
+    buffer.deAllocate();
+}
+
+TEST(zeroCopyRegions) {
+    ByteBuffer buffer;
+    buffer.init(10);
+    for (int start=0; start<10; start++) {
+        byte *region;
+        byte value = 0;
+        byte expected = 0;
+        startAt(buffer, start);
+        while (buffer.getSize() < 10) {
+            unsigned int n = buffer.getWriteRegion(&region);
+            CHECK(n > 0);
+            for (unsigned int i=0; i<n; i++) {
+                region[i] = value++;
+            }
+            buffer.commit(n);
+        }
+        CHECK_EQUAL(buffer.getWriteRegion(&region), 0u);
+        while (buffer.getSize() > 0) {
+            unsigned int n = buffer.getReadRegion(&region);
+            CHECK(n > 0);
+            for (unsigned int i=0; i<n; i++) {
+                CHECK_EQUAL(region[i], expected++);
+            }
+            buffer.consume(n);
+        }
+        CHECK_EQUAL(expected, 10);
+    }
+    buffer.deAllocate();
+}
+
+TEST(overwrite) {
+    ByteBuffer buffer;
+    byte in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    buffer.init(4);
+    buffer.setOverwrite(true);
+    for (int i=0; i<10; i++) {
+        buffer.put(i);
+    }
+    CHECK_EQUAL(buffer.getOverwriteCount(), 6ul);
+    CHECK_EQUAL(buffer.getSize(), 4);
+    for (int i=6; i<10; i++) {
+        CHECK_EQUAL(buffer.get(), i);
+    }
+    buffer.put(100);
+    CHECK_EQUAL(buffer.write(in, 10), 4u);
+    CHECK_EQUAL(buffer.getOverwriteCount(), 13ul);
+    for (int i=6; i<10; i++) {
+        CHECK_EQUAL(buffer.get(), i);
+    }
+    buffer.clearOverwriteCount();
+    CHECK_EQUAL(buffer.getOverwriteCount(), 0ul);
+    buffer.deAllocate();
+
+    // Nothing to overwrite without storage
+    CHECK_EQUAL(buffer.put(1), 0);
+    CHECK_EQUAL(buffer.write(in, 10), 0u);
+    CHECK_EQUAL(buffer.write(in, 0), 0u);
+    CHECK_EQUAL(buffer.getOverwriteCount(), 0ul);
+    byte out[4];
+    CHECK_EQUAL(buffer.read(out, 4), 0u);
+    CHECK_EQUAL(buffer.read(out, 0), 0u);
+    buffer.consume(4);
+    CHECK_EQUAL(buffer.getSize(), 0);
+}
+
+TEST(fixedByteBuffer) {
+    FixedByteBuffer<8> buffer;
+    CHECK_EQUAL(buffer.getCapacity(), 8);
+    for (int n=0; n<3; n++) {
+        for (int i=0; i<8; i++) {
+            CHECK_EQUAL(buffer.put(i), 1);
+        }
+        CHECK_EQUAL(buffer.put(8), 0);
+        CHECK_EQUAL(buffer.peek(7), 7);
+        for (int i=0; i<5; i++) {
+            CHECK_EQUAL(buffer.get(), i);
+        }
+        buffer.clear();
+    }
+}
+
+// Also built with BYTEBUFFER_STATS as test_bytebuffer_stats
+TEST(stats) {
+    ByteBuffer buffer;
+    ByteBufferStats stats;
+    byte out[8];
+    buffer.init(4);
+    buffer.put(1);
+    buffer.put(2);
+    buffer.put(3);
+    CHECK_EQUAL(buffer.putLong(4), 0);
+    buffer.get();
+    CHECK_EQUAL(buffer.read(out, 8), 2u);
+    buffer.getLong();
+    buffer.getStats(stats);
+#ifdef BYTEBUFFER_STATS
+    CHECK_EQUAL(stats.peakSize, 3u);
+    CHECK_EQUAL(stats.bytesIn, 3ul);
+    CHECK_EQUAL(stats.bytesOut, 3ul);
+    CHECK_EQUAL(stats.overflows, 1ul);
+    CHECK_EQUAL(stats.underflows, 1ul);
+    buffer.clearStats();
+    buffer.getStats(stats);
+#endif
+    CHECK_EQUAL(stats.peakSize, 0u);
+    CHECK_EQUAL(stats.bytesIn, 0ul);
+    CHECK_EQUAL(stats.bytesOut, 0ul);
+    CHECK_EQUAL(stats.overflows, 0ul);
+    CHECK_EQUAL(stats.underflows, 0ul);
+    buffer.deAllocate();
+}
+
+struct Record {
+    long timestamp;
+    int value;
+};
+
+TEST(recordRing) {
+    RecordRing<Record, 3> ring;
+    Record record;
+    for (int i=0; i<3; i++) {
+        record.timestamp = 1000+i;
+        record.value = -i;
+        CHECK_EQUAL(ring.push(record), 1);
+    }
+    CHECK_EQUAL(ring.push(record), 0);
+    CHECK_EQUAL(ring.peek(2)->timestamp, 1002);
+    CHECK(ring.peek(3) == 0);
+    CHECK_EQUAL(ring.pop(record), 1);
+    CHECK_EQUAL(record.timestamp, 1000);
+    record.timestamp = 1003;
+    CHECK_EQUAL(ring.push(record), 1);
+    for (int i=1; i<4; i++) {
+        CHECK_EQUAL(ring.pop(record), 1);
+        CHECK_EQUAL(record.timestamp, 1000+i);
+    }
+    CHECK_EQUAL(ring.pop(record), 0);
+}
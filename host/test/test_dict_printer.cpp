@@ -0,0 +1,26 @@
+// Host tests for DictPrinter, checks the text written to Serial
+#include "HostTest.h"
+#include "DictPrinter.h"
+#include <string>
+
+TEST(items) {
+    DictPrinter dict;
+    dict.start();
+    dict.addIntItem((char *) "a", -1);
+    dict.addLongItem((char *) "b", 100000);
+    dict.addStrItem((char *) "c", (char *) "xy");
+    dict.addCharItem((char *) "d", 'z');
+    dict.addEmptyItem((char *) "e");
+    dict.addLongTuple((char *) "f", 3, 1L, -2L, 3L);
+    CHECK_EQUAL(dict.len(), 6);
+    dict.stop();
+    CHECK_EQUAL(dict.len(), 0);
+    CHECK_EQUAL(hostSerialOutput(), std::string("{\"a\":-1,\"b\":100000,\"c\":\"xy\",\"d\":\"z\",\"e\":\"\",\"f\":(1,-2,3)}\r\n"));
+}
+
+TEST(empty) {
+    DictPrinter dict;
+    dict.start();
+    dict.stop();
+    CHECK_EQUAL(hostSerialOutput(), std::string("{}\r\n"));
+}
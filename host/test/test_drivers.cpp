@@ -0,0 +1,94 @@
+// Host tests for the device drivers against the mock SPI and TWI buses
+#include "HostTest.h"
+#include "SPI.h"
+#include "SoftwareSerial.h"
+#include "mcp4822.h"
+#include "mcp4261.h"
+#include "max1270.h"
+#include "SerialLCD.h"
+#include "FastWire.h"
+
+TEST(mcp4822) {
+    MCP4822 dac(10, 9);
+    dac.begin();
+    CHECK_EQUAL(hostGetPinMode(10), OUTPUT);
+    CHECK_EQUAL(digitalRead(10), HIGH);
+    hostSpiClearLog();
+    dac.setValue_A(1000);
+    dac.setGain1X_B();
+    dac.setValue_B(4095);
+    const std::vector<uint8_t> &log = hostSpiLog();
+    CHECK_EQUAL(log.size(), 4u);
+    CHECK_EQUAL((int) log[0], 0x13);
+    CHECK_EQUAL((int) log[1], 0xE8);
+    CHECK_EQUAL((int) log[2], 0xBF);
+    CHECK_EQUAL((int) log[3], 0xFF);
+    CHECK_EQUAL(digitalRead(10), HIGH);
+}
+
+TEST(mcp4261) {
+    MCP4261 pot(8);
+    pot.initialize();
+    hostSpiClearLog();
+    pot.setWiper0(0x80);
+    const std::vector<uint8_t> &log = hostSpiLog();
+    CHECK_EQUAL(log.size(), 2u);
+    CHECK_EQUAL((int) log[0] & 0xF0, 0x00);
+    CHECK_EQUAL((int) log[1], 0x80);
+}
+
+// The MAX1270 sends a 12 bit sample in the two bytes after the control byte
+static int max1270Transfers = 0;
+static uint8_t max1270Responder(uint8_t out) {
+    (void) out;
+    const uint8_t reply[] = {0x00, 0xF1, 0x20};
+    return reply[max1270Transfers++ % 3];
+}
+
+TEST(max1270) {
+    MAX1270 adc(2);
+    adc.initialize();
+    hostSpiClearLog();
+    hostSpiSetResponder(max1270Responder);
+    max1270Transfers = 0;
+    CHECK_EQUAL(adc.sample(3), (int16_t) 0xFF12);
+    CHECK_EQUAL(hostSpiLog().size(), 3u);
+    CHECK((hostSpiLog()[0] & 0x80) != 0);
+    CHECK(!hostSpiInTransaction());
+}
+
+TEST(serialLCD) {
+    SoftwareSerial port(2, 3);
+    SerialLCD lcd(port);
+    lcd.clearScreen();
+    lcd.setBrightness(50);
+    CHECK_EQUAL(port.output, std::string("\x7C\x00\x7C\x02\x32", 5));
+}
+
+TEST(fastWire) {
+    uint8_t registers[256] = {0};
+    registers[0x32] = 0x11;
+    registers[0x33] = 0x22;
+    hostTwiAddDevice(0x53, registers);
+    Wire.begin();
+
+    Wire.beginTransmission(0x53);
+    Wire.send(0x2D);
+    Wire.send(0x08);
+    CHECK_EQUAL((int) Wire.endTransmission(), 0);
+    CHECK_EQUAL((int) registers[0x2D], 0x08);
+
+    Wire.beginTransmission(0x53);
+    Wire.send(0x32);
+    Wire.endTransmission();
+    CHECK_EQUAL((int) Wire.requestFrom(0x53, 2), 2);
+    CHECK_EQUAL((int) Wire.available(), 2);
+    CHECK_EQUAL((int) Wire.receive(), 0x11);
+    CHECK_EQUAL((int) Wire.receive(), 0x22);
+
+    // No device at this address
+    Wire.beginTransmission(0x20);
+    Wire.send(0x00);
+    CHECK_EQUAL((int) Wire.endTransmission(), 2);
+    CHECK_EQUAL((int) Wire.requestFrom(0x20, 2), 0);
+}
@@ -0,0 +1,194 @@
+// Host tests for LookupTable, UniformLookupTable and LookupTableT. The
+// tables are compared against a linear scan that calls map() directly.
+#include "HostTest.h"
+#include "LookupTable.h"
+#include "UniformLookupTable.h"
+#include "LookupTableT.h"
+
+static int table[1024][2];
+static long slopes[1024];
+
+static int reference(int n, int x) {
+    if (x <= table[0][0]) {
+        return table[0][1];
+    }
+    if (x >= table[n-1][0]) {
+        return table[n-1][1];
+    }
+    for (int i=1; i<n; i++) {
+        if ((x >= table[i-1][0]) && (x < table[i][0])) {
+            return map(x, table[i-1][0], table[i][0], table[i-1][1], table[i][1]);
+        }
+    }
+    return 0;
+}
+
+// Random sorted table with repeated x values, returns the last x
+static int randomTable(int n, int maxStep) {
+    int x = -3000 + random(100);
+    for (int i=0; i<n; i++) {
+        x += random(maxStep);
+        table[i][0] = x;
+        table[i][1] = random(-10000, 10000);
+    }
+    return x;
+}
+
+TEST(lookupTable) {
+    randomSeed(3);
+    for (int iter=0; iter<300; iter++) {
+        int n = 1 + random(100);
+        int last = randomTable(n, 60);
+        for (int hint=0; hint<2; hint++) {
+            LookupTable lookup;
+            CHECK(lookup.setTable(table, n));
+            lookup.setHint(hint);
+            bool ok = true;
+            for (int x=-4000; x<last+100; x++) {
+                ok &= (lookup.getValue(x) == reference(n, x));
+            }
+            for (int k=0; k<2000; k++) {
+                int x = random(-4000, last+100);
+                ok &= (lookup.getValue(x) == reference(n, x));
+            }
+            CHECK(ok);
+        }
+    }
+    int unsorted[3][2] = {{0, 0}, {10, 1}, {5, 2}};
+    LookupTable lookup;
+    CHECK(!lookup.setTable(unsorted, 3));
+}
+
+TEST(lookupTableProgmem) {
+    randomSeed(9);
+    for (int iter=0; iter<200; iter++) {
+        int n = 1 + random(100);
+        int last = randomTable(n, 50);
+        LookupTable ram, flash;
+        CHECK_EQUAL(ram.setTable(table, n), flash.setTable_P(table, n));
+        flash.setHint(iter & 1);
+        bool ok = true;
+        for (int x=-3100; x<last+50; x++) {
+            ok &= (ram.getValue(x) == flash.getValue(x));
+        }
+        CHECK(ok);
+    }
+}
+
+TEST(lookupTableSlopes) {
+    randomSeed(11);
+    for (int iter=0; iter<1000; iter++) {
+        // Segments up to 256 wide are exact, wider ones may be off by one
+        int maxWidth = (iter % 2) ? 256 : 6000;
+        int n = 2 + random(20);
+        int x = -30000;
+        for (int i=0; i<n; i++) {
+            if (i) {
+                x += random(maxWidth + 1);
+            }
+            table[i][0] = x;
+            table[i][1] = random(-16000, 16000);
+        }
+        LookupTable exact, fast;
+        exact.setTable(table, n);
+        fast.setTable(table, n, slopes);
+        CHECK(fast.usingSlopes());
+        bool ok = true;
+        for (int q=-30010; q<x+10; q++) {
+            int diff = abs(exact.getValue(q) - fast.getValue(q));
+            ok &= (maxWidth > 256) ? (diff <= 1) : (diff == 0);
+        }
+        CHECK(ok);
+    }
+    int steep[2][2] = {{0, -20000}, {1, 20000}};
+    LookupTable lookup;
+    lookup.setTable(steep, 2, slopes);
+    CHECK(!lookup.usingSlopes());
+    CHECK_EQUAL(lookup.getValue(1), 20000);
+}
+
+TEST(uniformLookupTable) {
+    static int y[300];
+    const unsigned int steps[] = {1, 2, 3, 7, 8, 16, 100, 128, 1000, 4096};
+    randomSeed(5);
+    for (int iter=0; iter<400; iter++) {
+        unsigned int step = steps[random(10)];
+        int n = 1 + random(40);
+        if ((long) n*step > 60000) {
+            n = 60000/step;
+        }
+        int x0 = random(-30000, -10000);
+        for (int i=0; i<n; i++) {
+            y[i] = random(-32768, 32767);
+            table[i][0] = x0 + i*step;
+            table[i][1] = y[i];
+        }
+        LookupTable lookup;
+        UniformLookupTable uniform;
+        lookup.setTable(table, n);
+        CHECK(uniform.setTable(x0, step, y, n));
+        bool ok = true;
+        for (int k=0; k<3000; k++) {
+            int x = random(-32768, 32767);
+            ok &= (uniform.getValue(x) == lookup.getValue(x));
+        }
+        CHECK(ok);
+    }
+
+    // Steps above 32768 are not a power of two
+    int ends[2] = {-1000, 1000};
+    UniformLookupTable wide;
+    CHECK(wide.setTable(0, 40000U, ends, 2));
+    CHECK_EQUAL(wide.getValue(10000), -500);
+    CHECK_EQUAL(wide.getValue(30000), 500);
+}
+
+constexpr LT_Point<int,int> constTable[] = {{0, 0}, {10, 20}, {20, 40}, {25, -5}};
+static_assert(lt_isMonotonic(constTable), "constTable must be sorted");
+constexpr LT_Point<int,int> unsortedTable[] = {{0, 0}, {10, 20}, {5, 40}, {25, -5}};
+static_assert(!lt_isMonotonic(unsortedTable), "unsortedTable is not sorted");
+
+TEST(lookupTableT) {
+    static LT_Point<int,int> points[200];
+    static LT_Point<long,float> floatPoints[200];
+    const LookupTableT<int,int> constLookup(constTable);
+    CHECK_EQUAL(constLookup.getValue(22), 40 + (2*-45)/5);
+
+    randomSeed(2);
+    for (int iter=0; iter<300; iter++) {
+        int n = 1 + random(50);
+        int last = randomTable(n, 80);
+        for (int i=0; i<n; i++) {
+            points[i].x = table[i][0];
+            points[i].y = table[i][1];
+            floatPoints[i].x = table[i][0]*1000L;
+            floatPoints[i].y = table[i][1];
+        }
+        LookupTable lookup;
+        LookupTableT<int,int> intLookup;
+        LookupTableT<long,float> floatLookup;
+        lookup.setTable(table, n);
+        CHECK(intLookup.setTable(points, n));
+        CHECK(floatLookup.setTable(floatPoints, n));
+        bool ok = true;
+        for (int x=-3100; x<last+50; x++) {
+            ok &= (intLookup.getValue(x) == lookup.getValue(x));
+            ok &= (fabs(floatLookup.getValue(x*1000L) - lookup.getValue(x)) < 1.0001);
+        }
+        CHECK(ok);
+    }
+
+    static LT_Point<int,int> big[1000];
+    for (int n=1; n<1000; n+=37) {
+        for (int i=0; i<n; i++) {
+            big[i].x = i;
+            big[i].y = 0;
+        }
+        CHECK(lt_isMonotonic(big, 0, n));
+        for (int j=1; j<n; j++) {
+            big[j].x = -5;
+            CHECK(!lt_isMonotonic(big, 0, n));
+            big[j].x = j;
+        }
+    }
+}
@@ -0,0 +1,334 @@
+// Host tests for SerialReceiver and SerialDispatcher
+#include "HostTest.h"
+#include "SerialReceiver.h"
+#include "SerialDispatcher.h"
+#include <limits.h>
+#include <string>
+
+template<class R>
+static void feed(R &receiver, const char *str) {
+    while (*str) {
+        receiver.process(*str);
+        str++;
+    }
+}
+
+TEST(asciiItems) {
+    SerialReceiver receiver;
+    char str[10];
+    feed(receiver, "junk [12,-3.5,hello]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.numberOfItems(), 3);
+    CHECK_EQUAL(receiver.readInt(0), 12);
+    CHECK_EQUAL(receiver.readFloat(1), -3.5f);
+    receiver.copyString(2, str, sizeof(str));
+    CHECK(strcmp(str, "hello") == 0);
+    CHECK_EQUAL(receiver.itemLength(2), 5);
+    CHECK_EQUAL(receiver.readChar(2, 1), 'e');
+
+    receiver.reset();
+    feed(receiver, "[1 2, 3\n]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readInt(0), 12);
+    CHECK_EQUAL(receiver.readLong(1), 3);
+
+    receiver.reset();
+    feed(receiver, "[1.5e2,-2e-1,+7]");
+    CHECK_EQUAL(receiver.readDouble(0), 150.0);
+    CHECK(fabs(receiver.readDouble(1) + 0.2) < 1e-9);
+    CHECK_EQUAL(receiver.readInt(2), 7);
+
+    receiver.reset();
+    feed(receiver, "[]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.numberOfItems(), 0);
+}
+
+TEST(asciiErrors) {
+    SerialReceiver receiver;
+    feed(receiver, "[,1]");
+    CHECK(!receiver.messageReady());
+    receiver.reset();
+    feed(receiver, "[1,2,3,4,5]");
+    CHECK(receiver.messageReady());
+    receiver.reset();
+    feed(receiver, "[1,2,3,4,5,6]");
+    CHECK(!receiver.messageReady());
+    receiver.reset();
+    feed(receiver, "[aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa]");
+    CHECK(!receiver.messageReady());
+}
+
+static SR_Stats statsAfter(SerialReceiverBase &receiver, const char *str) {
+    SR_Stats stats;
+    receiver.reset();
+    receiver.clearStats();
+    feed(receiver, str);
+    receiver.getStats(stats);
+    return stats;
+}
+
+// One error per bad frame, the rest of it is skipped up to the next start
+TEST(errorStats) {
+    SerialReceiver receiver;
+    SR_Stats stats = statsAfter(receiver, "[1,[2,3]");
+    CHECK_EQUAL(stats.illegalChar, 1ul);
+    CHECK_EQUAL(stats.framesOk, 1ul);
+    CHECK_EQUAL(stats.discardedBytes, 0ul);
+    CHECK_EQUAL(receiver.readInt(0), 2);
+
+    stats = statsAfter(receiver, "[aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa][ok]");
+    CHECK_EQUAL(stats.itemLength, 1ul);
+    CHECK_EQUAL(stats.illegalChar, 0ul);
+    CHECK_EQUAL(stats.discardedBytes, 6ul);
+    CHECK_EQUAL(stats.framesOk, 1ul);
+
+    stats = statsAfter(receiver, "junk\n[1]");
+    CHECK_EQUAL(stats.illegalChar, 1ul);
+    CHECK_EQUAL(stats.discardedBytes, 4ul);
+    CHECK_EQUAL(stats.framesOk, 1ul);
+
+    const uint8_t schema[] = {SR_TYPE_INT};
+    receiver.setSchema(schema, 1);
+    stats = statsAfter(receiver, "[1.5,2] [3]");
+    CHECK_EQUAL(stats.numberFormat, 1ul);
+    CHECK_EQUAL(stats.illegalChar, 0ul);
+    CHECK_EQUAL(stats.discardedBytes, 5ul);
+    CHECK_EQUAL(stats.framesOk, 1ul);
+    CHECK_EQUAL(receiver.readInt(0), 3);
+}
+
+// The end of a frame dropped while the queue was full is skipped too
+TEST(dropStats) {
+    SizedSerialReceiver<2,4,8> receiver;
+    SR_Stats stats;
+    feed(receiver, "[a,1][b,");
+    receiver.pop();
+    feed(receiver, "2][c,3]");
+    receiver.getStats(stats);
+    CHECK_EQUAL(stats.framesOk, 2ul);
+    CHECK_EQUAL(stats.droppedFrames, 1ul);
+    CHECK_EQUAL(receiver.getDroppedFrames(), 1ul);
+    CHECK_EQUAL(stats.discardedBytes, 5ul);
+    CHECK_EQUAL(stats.illegalChar, 0ul);
+    CHECK_EQUAL(receiver.readInt(1), 3);
+}
+
+TEST(schema) {
+    SerialReceiver receiver;
+    const uint8_t schema[] = {SR_TYPE_STRING, SR_TYPE_INT, SR_TYPE_LONG, SR_TYPE_FLOAT};
+    char str[8];
+    receiver.setSchema(schema, 4);
+    feed(receiver, "[set,-12,123456,-3.25]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readInt(1), -12);
+    CHECK_EQUAL(receiver.readLong(2), 123456);
+    CHECK_EQUAL(receiver.readDouble(3), -3.25);
+    CHECK_EQUAL(receiver.readInt(3), -3);
+    receiver.copyString(0, str, sizeof(str));
+    CHECK(strcmp(str, "set") == 0);
+
+    const char *invalid[] = {"[set,1x]", "[set,1.5]", "[set,-,]", "[set,1-2]"};
+    for (int i=0; i<4; i++) {
+        receiver.reset();
+        feed(receiver, invalid[i]);
+        CHECK(!receiver.messageReady());
+    }
+
+    receiver.reset();
+    feed(receiver, "[set,5,6,.5,extra]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readDouble(3), 0.5);
+    receiver.clearSchema();
+    receiver.reset();
+    feed(receiver, "[1.5e1]");
+    CHECK_EQUAL(receiver.readDouble(0), 15.0);
+}
+
+TEST(intRange) {
+    SerialReceiver receiver;
+    const uint8_t schema[] = {SR_TYPE_INT};
+    char message[32];
+    receiver.setSchema(schema, 1);
+    snprintf(message, sizeof(message), "[%d]", INT_MIN);
+    feed(receiver, message);
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readInt(0), INT_MIN);
+    receiver.reset();
+    snprintf(message, sizeof(message), "[%d]", INT_MAX);
+    feed(receiver, message);
+    CHECK_EQUAL(receiver.readInt(0), INT_MAX);
+
+    snprintf(message, sizeof(message), "[%ld]", (long) INT_MIN - 1);
+    receiver.reset();
+    feed(receiver, message);
+    CHECK(!receiver.messageReady());
+    snprintf(message, sizeof(message), "[%ld]", (long) INT_MAX + 1);
+    receiver.reset();
+    feed(receiver, message);
+    CHECK(!receiver.messageReady());
+}
+
+TEST(fixedAndScaled) {
+    SerialReceiver receiver;
+    feed(receiver, "[1.235,-0.5,1.,0.123456789012,2.4999]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readScaledInt(0, 2), 124l);
+    CHECK_EQUAL(receiver.readFixed(0, 8), 316l);
+    // Halves round away from zero
+    CHECK_EQUAL(receiver.readScaledInt(1, 0), -1l);
+    CHECK_EQUAL(receiver.readFixed(1, 0), -1l);
+    CHECK_EQUAL(receiver.readFixed(1, 1), -1l);
+    CHECK_EQUAL(receiver.readScaledInt(2, 2), 100l);
+    CHECK_EQUAL(receiver.readFixed(2, 4), 16l);
+    // More fraction digits than asked for
+    CHECK_EQUAL(receiver.readScaledInt(3, 3), 123l);
+    CHECK_EQUAL(receiver.readScaledInt(3, 4), 1235l);
+    CHECK_EQUAL(receiver.readFixed(3, 16), 8091l);
+    CHECK_EQUAL(receiver.readScaledInt(4, 0), 2l);
+    CHECK_EQUAL(receiver.readScaledInt(4, 3), 2500l);
+    CHECK_EQUAL(receiver.readFixed(4, 0), 2l);
+
+    // Out of range values saturate
+    char message[64];
+    snprintf(message, sizeof(message), "[%ld,%ld.9]", LONG_MAX, LONG_MAX);
+    receiver.reset();
+    feed(receiver, message);
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readScaledInt(0, 0), LONG_MAX);
+    CHECK_EQUAL(receiver.readScaledInt(0, 1), LONG_MAX);
+    CHECK_EQUAL(receiver.readFixed(0, 0), LONG_MAX);
+    CHECK_EQUAL(receiver.readFixed(0, 1), LONG_MAX);
+    CHECK_EQUAL(receiver.readScaledInt(1, 0), LONG_MAX);
+    CHECK_EQUAL(receiver.readFixed(1, 0), LONG_MAX);
+    receiver.reset();
+    feed(receiver, "[99999999999999999999,-99999999999999999999]");
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readScaledInt(0, 2), LONG_MAX);
+    CHECK_EQUAL(receiver.readFixed(0, 8), LONG_MAX);
+    CHECK_EQUAL(receiver.readScaledInt(1, 2), -LONG_MAX);
+    CHECK_EQUAL(receiver.readFixed(1, 8), -LONG_MAX);
+}
+
+TEST(sizedReceivers) {
+    SizedSerialReceiver<12,6,48> big;
+    SizedSerialReceiver<2,4,8> small;
+    feed(big, "[1,2,3,4,5,6,7,8,9,10,11,12]");
+    CHECK(big.messageReady());
+    CHECK_EQUAL(big.readInt(11), 12);
+    feed(small, "[ab,cd]");
+    CHECK(small.messageReady());
+    small.reset();
+    feed(small, "[a,b,c]");
+    CHECK(!small.messageReady());
+    small.reset();
+    feed(small, "[abcde]");
+    CHECK(!small.messageReady());
+    // A copy has its own storage
+    SizedSerialReceiver<12,6,48> copy(big);
+    big.reset();
+    CHECK_EQUAL(copy.readInt(10), 11);
+
+    // SerialReceiver takes SR_MAX_ITEMS items of SR_MAX_ITEM_SZ characters
+    SerialReceiver receiver;
+    std::string message = "[";
+    for (int i=0; i<SR_MAX_ITEMS; i++) {
+        message += std::string(SR_MAX_ITEM_SZ, 'a'+i);
+        message += (i < SR_MAX_ITEMS-1) ? "," : "]";
+    }
+    feed(receiver, message.c_str());
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.numberOfItems(), SR_MAX_ITEMS);
+    CHECK_EQUAL(receiver.itemLength(SR_MAX_ITEMS-1), SR_MAX_ITEM_SZ);
+    CHECK_EQUAL(receiver.readChar(SR_MAX_ITEMS-1, SR_MAX_ITEM_SZ-1), 'a'+SR_MAX_ITEMS-1);
+}
+
+TEST(messageQueue) {
+    SizedSerialReceiver<3,8,16,3> receiver;
+    feed(receiver, "[a,1][b,2][c,3][d,4][e,5]");
+    CHECK_EQUAL(receiver.messageCount(), 3);
+    CHECK_EQUAL(receiver.getDroppedFrames(), 2ul);
+    CHECK_EQUAL(receiver.readChar(0, 0), 'a');
+    receiver.pop();
+    CHECK_EQUAL(receiver.readInt(1), 2);
+    receiver.pop();
+    feed(receiver, "[f,6]");
+    CHECK_EQUAL(receiver.readInt(1), 3);
+    receiver.pop();
+    CHECK_EQUAL(receiver.readInt(1), 6);
+    receiver.pop();
+    CHECK(!receiver.messageReady());
+}
+
+TEST(bulkProcess) {
+    SerialReceiver receiver;
+    const char *str = "[ab,-3.5][xyz]";
+    const uint8_t *data = (const uint8_t *) str;
+    size_t num = strlen(str);
+    size_t used = receiver.process(data, num);
+    CHECK_EQUAL(used, 9u);
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readDouble(1), -3.5);
+    // Queue full, nothing is used
+    CHECK_EQUAL(receiver.process(data+used, num-used), 0u);
+    receiver.pop();
+    used += receiver.process(data+used, num-used);
+    CHECK_EQUAL(used, num);
+    CHECK_EQUAL(receiver.itemLength(0), 3);
+}
+
+static int handled = -1;
+template<int N> static void handler(SerialReceiverBase &) { handled = N; }
+
+const char nameAlpha[] PROGMEM = "alpha";
+const char nameBeta[] PROGMEM = "beta";
+const char nameGet[] PROGMEM = "get";
+const char nameSet[] PROGMEM = "set";
+const char nameSetx[] PROGMEM = "setx";
+const SR_Command commands[] PROGMEM = {
+    {nameAlpha, handler<0>},
+    {nameBeta, handler<1>},
+    {nameGet, handler<2>},
+    {nameSet, handler<3>},
+    {nameSetx, handler<4>}
+};
+// Longer than SR_MAX_ITEM_SZ and only differing after it
+const char nameLong1[] PROGMEM = "abcdefghijklmnopqrstuvwxyz0123_a";
+const char nameLong2[] PROGMEM = "abcdefghijklmnopqrstuvwxyz0123_b";
+const SR_Command longNames[] PROGMEM = {
+    {nameLong1, handler<0>},
+    {nameLong2, handler<1>}
+};
+const SR_Command unsorted[] PROGMEM = {
+    {nameBeta, handler<1>},
+    {nameAlpha, handler<0>}
+};
+
+static bool dispatch(SerialDispatcher &dispatcher, SerialReceiver &receiver, const char *message) {
+    receiver.reset();
+    feed(receiver, message);
+    handled = -1;
+    return dispatcher.dispatch(receiver);
+}
+
+TEST(dispatcher) {
+    SerialDispatcher dispatcher;
+    SerialDispatcher other;
+    SerialReceiver receiver;
+    CHECK(dispatcher.setTable(commands, 5));
+    CHECK(!other.setTable(unsorted, 2));
+    CHECK(!dispatch(other, receiver, "[beta]"));
+    CHECK_EQUAL(other.find(receiver), -1);
+    CHECK_EQUAL(handled, -1);
+    CHECK(other.setTable(longNames, 2));
+    const char *messages[] = {"[alpha]", "[beta,1]", "[get]", "[set,1]", "[setx]"};
+    for (int i=0; i<5; i++) {
+        CHECK(dispatch(dispatcher, receiver, messages[i]));
+        CHECK_EQUAL(handled, i);
+    }
+    const char *unknown[] = {"[se]", "[zzz]", "[a]", "[]", "[sets]"};
+    for (int i=0; i<5; i++) {
+        CHECK(!dispatch(dispatcher, receiver, unknown[i]));
+        CHECK_EQUAL(handled, -1);
+    }
+}
@@ -0,0 +1,292 @@
+// Host tests for SerialReceiver's binary framing mode. Frames are built with
+// a small encoder here, and when Python is available also read from test 
+// vectors written by SerialReceiver/host/sr_binary.py (SR_VECTORS_FILE), 
+// some of them corrupted.
+#include "HostTest.h"
+#include "SerialReceiver.h"
+#include <limits.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes item(uint8_t type, const void *data, uint8_t len) {
+    Bytes out(1, (type << SR_BIN_TYPE_SHIFT) | len);
+    for (uint8_t i=0; i<len; i++) {
+        out.push_back(((const uint8_t *) data)[i]);
+    }
+    return out;
+}
+
+static Bytes int32Item(int32_t value) {
+    return item(SR_TYPE_LONG, &value, 4);
+}
+
+static Bytes int16Item(int16_t value) {
+    return item(SR_TYPE_INT, &value, 2);
+}
+
+static Bytes floatItem(float value) {
+    return item(SR_TYPE_FLOAT, &value, 4);
+}
+
+static Bytes stringItem(const char *str) {
+    return item(SR_TYPE_STRING, str, strlen(str));
+}
+
+// COBS encodes the items and their CRC-16/CCITT, with the 0x00 delimiter
+static Bytes frame(const std::vector<Bytes> &items) {
+    Bytes payload;
+    for (size_t i=0; i<items.size(); i++) {
+        payload.insert(payload.end(), items[i].begin(), items[i].end());
+    }
+    uint16_t crc = 0xFFFF;
+    for (size_t i=0; i<payload.size(); i++) {
+        crc ^= (uint16_t) payload[i] << 8;
+        for (int j=0; j<8; j++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    payload.push_back(crc >> 8);
+    payload.push_back(crc & 0xFF);
+    Bytes out;
+    size_t code = 0;
+    out.push_back(1);
+    for (size_t i=0; i<payload.size(); i++) {
+        if (payload[i] == 0) {
+            code = out.size();
+            out.push_back(1);
+        }
+        else {
+            out.push_back(payload[i]);
+            out[code]++;
+        }
+    }
+    out.push_back(0);
+    return out;
+}
+
+template<class R>
+static void feed(R &receiver, const Bytes &data) {
+    for (size_t i=0; i<data.size(); i++) {
+        receiver.process((int) data[i]);
+    }
+}
+
+TEST(typedItems) {
+    SerialReceiver receiver;
+    receiver.setMode(SR_MODE_BINARY);
+    std::vector<Bytes> items;
+    items.push_back(int32Item(150000));
+    items.push_back(floatItem(-1.25f));
+    items.push_back(int16Item(-300));
+    items.push_back(stringItem("42.5"));
+    items.push_back(stringItem("set"));
+    feed(receiver, frame(items));
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.numberOfItems(), 5);
+    CHECK_EQUAL(receiver.readLong(0), 150000);
+    CHECK_EQUAL(receiver.readDouble(0), 150000.0);
+    CHECK_EQUAL(receiver.readFloat(0), 150000.0f);
+    CHECK_EQUAL(receiver.readDouble(1), -1.25);
+    CHECK_EQUAL(receiver.readLong(1), -1);
+    CHECK_EQUAL(receiver.readInt(2), -300);
+    CHECK_EQUAL(receiver.readDouble(2), -300.0);
+    // String items are text, as in ASCII mode
+    CHECK_EQUAL(receiver.readDouble(3), 42.5);
+    CHECK_EQUAL(receiver.readLong(3), 42);
+    CHECK_EQUAL(receiver.itemLength(4), 3);
+    CHECK_EQUAL(receiver.readChar(4, 2), 't');
+}
+
+const char nameGet[] PROGMEM = "get";
+
+// Binary string items may contain zero bytes, which must not end the item
+TEST(compareWithZeroBytes) {
+    SerialReceiver receiver;
+    receiver.setMode(SR_MODE_BINARY);
+    std::vector<Bytes> items;
+    items.push_back(item(SR_TYPE_STRING, "get\0", 4));
+    items.push_back(item(SR_TYPE_STRING, "ge\0", 3));
+    items.push_back(stringItem("get"));
+    feed(receiver, frame(items));
+    CHECK(receiver.compareItem_P(0, nameGet) > 0);
+    CHECK(receiver.compareItem_P(1, nameGet) < 0);
+    CHECK_EQUAL(receiver.compareItem_P(2, nameGet), 0);
+}
+
+TEST(invalidNumericLength) {
+    SerialReceiver receiver;
+    SR_Stats stats;
+    receiver.setMode(SR_MODE_BINARY);
+    uint8_t data[3] = {1, 2, 3};
+    std::vector<Bytes> items(1, item(SR_TYPE_INT, data, 3));
+    feed(receiver, frame(items));
+    items[0] = item(SR_TYPE_FLOAT, data, 2);
+    feed(receiver, frame(items));
+    CHECK(!receiver.messageReady());
+    receiver.getStats(stats);
+    CHECK_EQUAL(stats.numberFormat, 2ul);
+    items[0] = int16Item(7);
+    feed(receiver, frame(items));
+    CHECK_EQUAL(receiver.readInt(0), 7);
+}
+
+// A frame lost to a full queue counts even when its delimiter only arrives
+// after the queue has room again
+TEST(dropStats) {
+    SizedSerialReceiver<2,8,16> receiver;
+    SR_Stats stats;
+    receiver.setMode(SR_MODE_BINARY);
+    std::vector<Bytes> items(1, int16Item(1));
+    feed(receiver, frame(items));
+    items[0] = int16Item(2);
+    Bytes dropped = frame(items);
+    feed(receiver, Bytes(dropped.begin(), dropped.begin()+3));
+    receiver.pop();
+    feed(receiver, Bytes(dropped.begin()+3, dropped.end()));
+    CHECK(!receiver.messageReady());
+    items[0] = int16Item(3);
+    feed(receiver, frame(items));
+    receiver.getStats(stats);
+    CHECK_EQUAL(stats.framesOk, 2ul);
+    CHECK_EQUAL(stats.droppedFrames, 1ul);
+    CHECK_EQUAL(receiver.getDroppedFrames(), 1ul);
+    CHECK(receiver.messageReady());
+    CHECK_EQUAL(receiver.readInt(0), 3);
+}
+
+TEST(fixedAndScaled) {
+    SerialReceiver receiver;
+    receiver.setMode(SR_MODE_BINARY);
+    std::vector<Bytes> items;
+    items.push_back(int32Item(150000));
+    items.push_back(int16Item(-3));
+    items.push_back(floatItem(1.25f));
+    items.push_back(floatItem(-1.25f));
+    items.push_back(floatItem(0.1f));
+    feed(receiver, frame(items));
+    CHECK_EQUAL(receiver.readScaledInt(0, 2), 15000000l);
+    CHECK_EQUAL(receiver.readFixed(0, 4), 2400000l);
+    CHECK_EQUAL(receiver.readScaledInt(1, 3), -3000l);
+    CHECK_EQUAL(receiver.readFixed(1, 8), -768l);
+    CHECK_EQUAL(receiver.readScaledInt(2, 1), 13l);
+    CHECK_EQUAL(receiver.readFixed(2, 1), 3l);
+    CHECK_EQUAL(receiver.readScaledInt(3, 1), -13l);
+    CHECK_EQUAL(receiver.readFixed(3, 1), -3l);
+    CHECK_EQUAL(receiver.readScaledInt(4, 3), 100l);
+    CHECK_EQUAL(receiver.readFixed(4, 16), 6554l);
+    receiver.pop();
+
+    // readFixed converts floats without float math, compare with round()
+    randomSeed(4);
+    bool ok = true;
+    for (int i=0; i<20000; i++) {
+        float value = (float) random(-2000000000L, 2000000000L)/(float) (1L << random(31));
+        uint8_t fracBits = random(17);
+        double expected = round((double) value*(1L << fracBits));
+        if (fabs(expected) >= 2147483647.0) {
+            continue;
+        }
+        items.assign(1, floatItem(value));
+        feed(receiver, frame(items));
+        if (receiver.readFixed(0, fracBits) != (long) expected) {
+            std::cerr << "    readFixed(" << value << ", " << (int) fracBits << ") = " 
+                << receiver.readFixed(0, fracBits) << std::endl;
+            ok = false;
+        }
+        receiver.pop();
+    }
+    CHECK(ok);
+    items.assign(1, floatItem(1e30f));
+    feed(receiver, frame(items));
+    CHECK_EQUAL(receiver.readFixed(0, 8), LONG_MAX);
+}
+
+#ifdef SR_VECTORS_FILE
+
+static Bytes fromHex(const std::string &str) {
+    Bytes out;
+    if (str == "-") {
+        return out;
+    }
+    for (size_t i=0; i+1<str.size(); i+=2) {
+        out.push_back((uint8_t) strtol(str.substr(i, 2).c_str(), 0, 16));
+    }
+    return out;
+}
+
+// Frames are fed back to back without resetting, so the receiver also has
+// to resynchronize after the corrupted ones.
+TEST(pythonVectors) {
+    SizedSerialReceiver<5,16,80,2> receiver;
+    receiver.setMode(SR_MODE_BINARY);
+    std::ifstream in(SR_VECTORS_FILE);
+    CHECK(in.good());
+    std::string line;
+    int intact = 0;
+    int corrupted = 0;
+    int undetected = 0;
+    bool ok = true;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        int flag;
+        std::string hexFrame;
+        fields >> flag >> hexFrame;
+        feed(receiver, fromHex(hexFrame));
+        if (flag == 0) {
+            corrupted++;
+            if (receiver.messageReady()) {
+                undetected++;
+            }
+            while (receiver.messageReady()) {
+                receiver.pop();
+            }
+            continue;
+        }
+        intact++;
+        if (receiver.messageCount() != 1) {
+            std::cerr << "    frame " << hexFrame << " not received" << std::endl;
+            ok = false;
+            continue;
+        }
+        std::string field;
+        uint8_t itemNum = 0;
+        while (fields >> field) {
+            size_t sep1 = field.find(':');
+            size_t sep2 = field.find(':', sep1+1);
+            int type = atoi(field.substr(0, sep1).c_str());
+            Bytes data = fromHex(field.substr(sep1+1, sep2-sep1-1));
+            std::string value = field.substr(sep2+1);
+            bool itemOk = (receiver.itemLength(itemNum) == data.size());
+            for (size_t j=0; j<data.size(); j++) {
+                itemOk &= ((uint8_t) receiver.readChar(itemNum, j) == data[j]);
+            }
+            if ((type == SR_TYPE_INT) || (type == SR_TYPE_LONG)) {
+                long expected = atol(value.c_str());
+                itemOk &= (receiver.readLong(itemNum) == expected);
+                itemOk &= (receiver.readDouble(itemNum) == (double) expected);
+            }
+            else if (type == SR_TYPE_FLOAT) {
+                double expected = strtod(value.c_str(), 0);
+                itemOk &= (receiver.readDouble(itemNum) == expected);
+                itemOk &= (receiver.readLong(itemNum) == (long) expected);
+            }
+            if (!itemOk) {
+                std::cerr << "    frame " << hexFrame << " item " << (int) itemNum << " differs" << std::endl;
+                ok = false;
+            }
+            itemNum++;
+        }
+        ok &= (receiver.numberOfItems() == itemNum);
+        receiver.pop();
+    }
+    CHECK(ok);
+    CHECK(intact > 1000);
+    CHECK(corrupted > 500);
+    CHECK_EQUAL(undetected, 0);
+}
+
+#endif
@@ -0,0 +1,113 @@
+// Host tests for running SerialReceiver from a receive interrupt. A thread
+// stands in for the UART RX interrupt and feeds bytes while the test, in
+// the role of loop(), reads and pops the queued messages.
+#include "HostTest.h"
+#include "SerialReceiver.h"
+#include "SpscByteBuffer.h"
+#include <atomic>
+#include <thread>
+
+static std::atomic<long> callbackCount(0);
+
+static void onMessage(SerialReceiverBase &receiver) {
+    callbackCount++;
+}
+
+// Reads messages "[m,<n>]" until the source is done, checks that they come
+// in order and returns how many were read
+static long readMessages(SerialReceiverBase &receiver, std::atomic<bool> &done, long &errors) {
+    long last = -1;
+    long count = 0;
+    while (!done || receiver.messageReady()) {
+        if (receiver.messageReady()) {
+            long value = receiver.readLong(1);
+            if ((value <= last) || (receiver.readChar(0, 0) != 'm')) {
+                errors++;
+            }
+            last = value;
+            count++;
+            receiver.pop();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    return count;
+}
+
+// The interrupt calls process() directly, messages arriving while the
+// queue is full are dropped and counted
+TEST(processFromInterrupt) {
+    const long numMessages = 200000;
+    SizedSerialReceiver<2,8,16,4> receiver;
+    std::atomic<bool> done(false);
+    callbackCount = 0;
+    receiver.setCallback(onMessage);
+    std::thread rx([&receiver, &done, numMessages]() {
+        char message[32];
+        for (long i=0; i<numMessages; i++) {
+            int len = snprintf(message, sizeof(message), "[m,%ld]", i);
+            for (int k=0; k<len; k++) {
+                receiver.process(message[k]);
+            }
+            if (i % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        done = true;
+    });
+    long errors = 0;
+    long count = readMessages(receiver, done, errors);
+    rx.join();
+    CHECK_EQUAL(errors, 0l);
+    CHECK_EQUAL(callbackCount, count);
+    CHECK_EQUAL(count + (long) receiver.getDroppedFrames(), numMessages);
+}
+
+// The interrupt only stores bytes in an SpscByteBuffer and loop() drains it
+// into the receiver, nothing is lost as long as the buffer does not fill
+TEST(processFromBuffer) {
+    const long numMessages = 100000;
+    SpscByteBuffer buffer;
+    SizedSerialReceiver<2,8,16> receiver;
+    std::atomic<bool> done(false);
+    buffer.init(64);
+    std::thread rx([&buffer, &done, numMessages]() {
+        char message[32];
+        for (long i=0; i<numMessages; i++) {
+            int len = snprintf(message, sizeof(message), "[m,%ld]", i);
+            for (int k=0; k<len; ) {
+                if (buffer.put(message[k])) {
+                    k++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        done = true;
+    });
+    long errors = 0;
+    long count = 0;
+    long last = -1;
+    while (!done || (buffer.getSize() > 0)) {
+        if (buffer.getSize() == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        receiver.process(buffer.get());
+        if (receiver.messageReady()) {
+            if (receiver.readLong(1) != last + 1) {
+                errors++;
+            }
+            last = receiver.readLong(1);
+            count++;
+            receiver.pop();
+        }
+    }
+    rx.join();
+    CHECK_EQUAL(errors, 0l);
+    CHECK_EQUAL(count, numMessages);
+    CHECK_EQUAL(receiver.getDroppedFrames(), 0ul);
+    buffer.deAllocate();
+}
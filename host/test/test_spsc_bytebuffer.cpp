@@ -0,0 +1,80 @@
+// Host tests for SpscByteBuffer, including a producer and a consumer thread
+// passing millions of bytes through a small buffer
+#include "HostTest.h"
+#include "SpscByteBuffer.h"
+#include <thread>
+
+TEST(putAndGet) {
+    SpscByteBuffer buffer;
+    CHECK(buffer.init(3));
+    CHECK_EQUAL(buffer.getCapacity(), 3);
+    for (int n=0; n<4; n++) {
+        for (int i=0; i<3; i++) {
+            CHECK_EQUAL(buffer.put(10*n + i), 1);
+        }
+        CHECK_EQUAL(buffer.put(99), 0);
+        CHECK_EQUAL(buffer.getSize(), 3);
+        CHECK_EQUAL(buffer.peek(2), 10*n + 2);
+        for (int i=0; i<3; i++) {
+            CHECK_EQUAL(buffer.get(), 10*n + i);
+        }
+        CHECK_EQUAL(buffer.getSize(), 0);
+    }
+    buffer.deAllocate();
+
+    byte storage[1];
+    CHECK(!buffer.init(storage, 1));
+    CHECK_EQUAL(buffer.put(1), 0);
+
+    // The indices are single bytes
+    CHECK(!buffer.init(256));
+    CHECK(buffer.init(255));
+    CHECK_EQUAL(buffer.getCapacity(), 255);
+    for (int i=0; i<255; i++) {
+        CHECK_EQUAL(buffer.put(i), 1);
+    }
+    CHECK_EQUAL(buffer.put(0), 0);
+    CHECK_EQUAL(buffer.getSize(), 255);
+    for (int i=0; i<255; i++) {
+        CHECK_EQUAL(buffer.get(), i);
+    }
+    CHECK_EQUAL(buffer.getSize(), 0);
+    buffer.deAllocate();
+}
+
+TEST(twoThreads) {
+    const long numBytes = 4000000;
+    SpscByteBuffer buffer;
+    CHECK(buffer.init(37));
+    int capacity = buffer.getCapacity();
+    std::thread producer([&buffer, numBytes]() {
+        for (long i=0; i<numBytes; ) {
+            if (buffer.put((byte) (i*7 + (i >> 8)))) {
+                i++;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    long errors = 0;
+    for (long i=0; i<numBytes; ) {
+        int size = buffer.getSize();
+        if (size < 0 || size > capacity) {
+            errors++;
+        }
+        if (size > 0) {
+            if (buffer.get() != (byte) (i*7 + (i >> 8))) {
+                errors++;
+            }
+            i++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK_EQUAL(errors, 0l);
+    CHECK_EQUAL(buffer.getSize(), 0);
+    buffer.deAllocate();
+}
@@ -63,7 +63,7 @@ def get_paths():
     dst_paths = []
     for item in dir_list:
         if os.path.isdir(item):
-            if item == '.hg':
+            if item in ('.hg', 'host'):
                 continue
             src = os.path.join(curdir,item)
             dst = os.path.join(LIBDIR,item)
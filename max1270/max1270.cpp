@@ -13,7 +13,6 @@
 #endif
 #include "SPI.h"
 #include "max1270.h"
-#include "Streaming.h"
 
 // Definitions
 const uint8_t CLK_INTERNAL  = 0b00000000;